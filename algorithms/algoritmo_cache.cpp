@@ -5,12 +5,34 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <functional>
 
 using namespace std;
 
+// Por que um item saiu do cache
+enum MotivoRemocao {
+    REMOCAO_MAIS_ANTIGO, // FIFO: primeiro a entrar
+    REMOCAO_MENOS_RECENTE, // LRU: menos recentemente usado
+    REMOCAO_2Q_ENTRADA, // 2Q: fila FIFO de itens novos
+    REMOCAO_2Q_FREQUENTE, // 2Q: fila LRU de itens frequentes
+    REMOCAO_TROCA_ALGORITMO, // Cache descartado na troca de algoritmo
+    NUM_MOTIVOS_REMOCAO
+};
+
 class AlgoritmoCache {
+protected:
+    function<void(int id, MotivoRemocao motivo)> observador_remocao; // Avisado a cada remoção
+
+    void notificar_remocao(int id, MotivoRemocao motivo) {
+        if (observador_remocao) observador_remocao(id, motivo);
+    }
+
 public:
     virtual ~AlgoritmoCache() = default;
+
+    void set_observador_remocao(function<void(int id, MotivoRemocao motivo)> observador) {
+        observador_remocao = observador; // Usado por métricas e camadas acima do algoritmo
+    }
     
     virtual string buscar_texto(int id) = 0; // Busca texto pelo identificador único
 
@@ -25,6 +47,10 @@ public:
     virtual vector<int> get_ids_cache() const = 0; // Retorna os IDs atualmente armazenados
 
     virtual void set_modo_silencioso(bool silencioso) = 0; // Ativa ou desativa logs de saída
+
+    virtual bool remover_proximo() = 0; // Remove o item que a política tiraria primeiro; false se vazio
+
+    virtual void set_capacidade(int cap) = 0; // Novo limite de itens; o excesso é removido
 };
 
 #endif
\ No newline at end of file
@@ -83,6 +83,7 @@ private:
             fifo_queue.pop_front(); // Remove da FIFO
             fifo_positions.erase(id_remover);
             cache_data.erase(id_remover);
+            notificar_remocao(id_remover, REMOCAO_2Q_ENTRADA);
             
             if (!modo_silencioso) {
                 cout << "🗑️  2Q: Removendo texto " << id_remover << " da FIFO" << endl;
@@ -93,6 +94,7 @@ private:
             lru_queue.pop_front(); // Remove da LRU
             lru_positions.erase(id_remover);
             cache_data.erase(id_remover);
+            notificar_remocao(id_remover, REMOCAO_2Q_FREQUENTE);
             
             if (!modo_silencioso) {
                 cout << "🗑️  2Q: Removendo texto " << id_remover << " da LRU (menos recente)" << endl;
@@ -101,6 +103,17 @@ private:
     }
 
 public:
+    bool remover_proximo() override {
+        if (cache_data.empty()) return false;
+        remover_pagina();
+        return true;
+    }
+
+    void set_capacidade(int cap) override {
+        capacidade = cap;
+        while ((int)cache_data.size() > capacidade) remover_pagina();
+    }
+
     pair<int, int> get_estatisticas() const override {
         return {hits, misses}; // Retorna estatísticas de uso
     }
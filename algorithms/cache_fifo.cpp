@@ -42,13 +42,7 @@ public:
         }
         
         if (fifo_queue.size() >= capacidade) {
-            int id_remover = fifo_queue.front(); // Remove o mais antigo
-            fifo_queue.pop_front();
-            cache_data.erase(id_remover);
-            
-            if (!modo_silencioso) {
-                cout << "🗑️  FIFO: Removendo texto " << id_remover << endl;
-            }
+            remover_proximo(); // Remove o mais antigo
         }
         
         fifo_queue.push_back(id); // Adiciona o novo texto
@@ -59,6 +53,24 @@ public:
         }
     }
 
+    bool remover_proximo() override {
+        if (fifo_queue.empty()) return false;
+        int id_remover = fifo_queue.front(); // Remove o mais antigo
+        fifo_queue.pop_front();
+        cache_data.erase(id_remover);
+        notificar_remocao(id_remover, REMOCAO_MAIS_ANTIGO);
+
+        if (!modo_silencioso) {
+            cout << "🗑️  FIFO: Removendo texto " << id_remover << endl;
+        }
+        return true;
+    }
+
+    void set_capacidade(int cap) override {
+        capacidade = cap;
+        while ((int)fifo_queue.size() > capacidade) remover_proximo();
+    }
+
     pair<int, int> get_estatisticas() const override {
         return {hits, misses}; // Retorna hits e misses
     }
@@ -45,12 +45,7 @@ public:
         }
         
         if (cache_list.size() >= capacidade) {
-            int id_remover = cache_list.front().first; // Remove o menos recentemente usado
-            if (!modo_silencioso) {
-                cout << "🗑️  LRU: Removendo texto " << id_remover << endl;
-            }
-            cache_map.erase(id_remover);
-            cache_list.pop_front();
+            remover_proximo(); // Remove o menos recentemente usado
         }
         
         cache_list.push_back({id, conteudo}); // Adiciona o novo texto
@@ -60,6 +55,23 @@ public:
         }
     }
 
+    bool remover_proximo() override {
+        if (cache_list.empty()) return false;
+        int id_remover = cache_list.front().first; // Remove o menos recentemente usado
+        if (!modo_silencioso) {
+            cout << "🗑️  LRU: Removendo texto " << id_remover << endl;
+        }
+        cache_map.erase(id_remover);
+        cache_list.pop_front();
+        notificar_remocao(id_remover, REMOCAO_MENOS_RECENTE);
+        return true;
+    }
+
+    void set_capacidade(int cap) override {
+        capacidade = cap;
+        while ((int)cache_list.size() > capacidade) remover_proximo();
+    }
+
     pair<int, int> get_estatisticas() const override {
         return {hits, misses}; // Retorna hits e misses
     }
@@ -0,0 +1,173 @@
+#ifndef ARMAZEM_CHUNKS_CPP
+#define ARMAZEM_CHUNKS_CPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+using namespace std;
+
+// Armazém de chunks com contagem de referências. Os textos são cortados em chunks
+// definidos pelo conteúdo (hash rolante Gear): um trecho igual em dois textos gera os
+// mesmos chunks mesmo em posições diferentes, e é guardado uma única vez.
+// Um texto armazenado vira uma referência: a lista dos IDs de seus chunks (8 bytes cada).
+class ArmazemChunks {
+public:
+    static constexpr size_t TAMANHO_MIN = 64; // Nenhum corte antes disso
+    static constexpr size_t TAMANHO_MAX = 1024; // Corte forçado
+    static constexpr uint64_t MASCARA_CORTE = (1ULL << 8) - 1; // Corte médio a cada ~256 bytes após o mínimo
+    // Controle de cada chunk além do conteúdo (estimativa): chave e nó do unordered_map com
+    // seu balde, o std::string, o bloco de controle do shared_ptr e o cabeçalho das 2 alocações
+    static constexpr size_t CUSTO_CONTROLE_CHUNK =
+        sizeof(uint64_t) + sizeof(shared_ptr<const string>) + sizeof(uint32_t) + 2 * sizeof(void*)
+        + sizeof(string) + 2 * sizeof(long) + 2 * 16;
+
+private:
+    struct Chunk {
+        shared_ptr<const string> dados; // Conteúdo único do chunk, compartilhado com quem o lê
+        uint32_t referencias; // Quantas referências vivas usam o chunk
+    };
+
+    unordered_map<uint64_t, Chunk> chunks; // ID -> chunk
+    size_t total_logico = 0; // Bytes de todas as referências vivas
+    size_t total_fisico = 0; // Bytes dos chunks únicos guardados
+    size_t total_referencias = 0; // Entradas de 8 bytes nas referências vivas
+
+    static const uint64_t* tabela_gear() {
+        static uint64_t tabela[256];
+        static bool pronta = [] {
+            uint64_t estado = 0x9E3779B97F4A7C15ULL; // splitmix64 com semente fixa: cortes reprodutíveis
+            for (auto& valor : tabela) {
+                uint64_t z = (estado += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                valor = z ^ (z >> 31);
+            }
+            return true;
+        }();
+        (void)pronta;
+        return tabela;
+    }
+
+    static uint64_t impressao(const char* p, size_t n) {
+        uint64_t h = 0xCBF29CE484222325ULL; // FNV-1a 64
+        for (size_t i = 0; i < n; i++) {
+            h ^= (unsigned char)p[i];
+            h *= 0x100000001B3ULL;
+        }
+        return h;
+    }
+
+    static uint64_t ler_id(const string& referencia, size_t i) {
+        uint64_t id;
+        memcpy(&id, referencia.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+        return id;
+    }
+
+public:
+    // Posições de fim de cada chunk de 'dados'
+    static vector<size_t> cortar(const string& dados) {
+        const uint64_t* gear = tabela_gear();
+        vector<size_t> cortes;
+        size_t inicio = 0;
+        while (inicio < dados.size()) {
+            size_t limite = min(dados.size(), inicio + TAMANHO_MAX);
+            size_t pos = min(limite, inicio + TAMANHO_MIN);
+            uint64_t hash = 0;
+            while (pos < limite) {
+                hash = (hash << 1) + gear[(unsigned char)dados[pos]];
+                pos++;
+                if ((hash & (MASCARA_CORTE << 48)) == 0) break; // Bits altos: dependem só da janela dos últimos ~56 bytes
+            }
+            cortes.push_back(pos);
+            inicio = pos;
+        }
+        return cortes;
+    }
+
+    // Guarda 'dados' e retorna a referência; chunks já existentes só ganham uma referência
+    string armazenar(const string& dados) {
+        string referencia;
+        size_t inicio = 0;
+        for (size_t fim : cortar(dados)) {
+            uint64_t id = impressao(dados.data() + inicio, fim - inicio);
+            while (true) {
+                auto it = chunks.find(id);
+                if (it == chunks.end()) {
+                    chunks[id] = {make_shared<const string>(dados, inicio, fim - inicio), 1};
+                    total_fisico += fim - inicio;
+                    break;
+                }
+                if (it->second.dados->compare(0, string::npos, dados, inicio, fim - inicio) == 0) {
+                    it->second.referencias++;
+                    break;
+                }
+                id++; // Colisão de impressão: tenta o próximo ID
+            }
+            referencia.append((const char*)&id, sizeof(id));
+            inicio = fim;
+        }
+        total_logico += dados.size();
+        total_referencias += referencia.size() / sizeof(uint64_t);
+        return referencia;
+    }
+
+    string reconstruir(const string& referencia) const {
+        string dados;
+        for (const auto& chunk : pedacos(referencia)) dados += *chunk;
+        return dados;
+    }
+
+    // Chunks de uma referência, na ordem, sem copiar o conteúdo
+    vector<shared_ptr<const string>> pedacos(const string& referencia) const {
+        vector<shared_ptr<const string>> resultado;
+        for (size_t i = 0; i < referencia.size() / sizeof(uint64_t); i++) {
+            resultado.push_back(chunks.at(ler_id(referencia, i)).dados);
+        }
+        return resultado;
+    }
+
+    // Solta uma referência; chunks sem referências são apagados
+    void liberar(const string& referencia) {
+        for (size_t i = 0; i < referencia.size() / sizeof(uint64_t); i++) {
+            auto it = chunks.find(ler_id(referencia, i));
+            if (it == chunks.end()) continue;
+            total_logico -= it->second.dados->size();
+            if (--it->second.referencias == 0) {
+                total_fisico -= it->second.dados->size();
+                chunks.erase(it);
+            }
+        }
+        total_referencias -= referencia.size() / sizeof(uint64_t);
+    }
+
+    void limpar() {
+        chunks.clear();
+        total_logico = 0;
+        total_fisico = 0;
+        total_referencias = 0;
+    }
+
+    size_t bytes_logicos() const { return total_logico; }
+    size_t bytes_fisicos() const { return total_fisico; }
+    size_t bytes_referencias() const { return total_referencias * sizeof(uint64_t); }
+    size_t bytes_controle() const { return chunks.size() * CUSTO_CONTROLE_CHUNK; }
+    size_t num_chunks() const { return chunks.size(); }
+
+    // Memória que o dedup realmente usa: chunks únicos, referências e o controle dos chunks
+    size_t bytes_ocupados() const {
+        return total_fisico + bytes_referencias() + bytes_controle();
+    }
+
+    // Bytes que os textos ocupariam sem dedup / bytes ocupados com dedup (abaixo de 1: dedup gasta mais)
+    double razao_dedup() const {
+        return bytes_ocupados() == 0 ? 1.0 : (double)total_logico / bytes_ocupados();
+    }
+};
+
+#endif
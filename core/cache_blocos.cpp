@@ -0,0 +1,233 @@
+#ifndef CACHE_BLOCOS_CPP
+#define CACHE_BLOCOS_CPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <algorithm>
+#include <iomanip>
+#include <unordered_map>
+#include <limits>
+#include "../algorithms/algoritmo_cache.cpp"
+#include "metricas.cpp"
+#include "armazem_chunks.cpp"
+#include "faixa_texto.cpp"
+
+using namespace std;
+
+// Cache por faixas: cada texto é dividido em blocos de tamanho fixo e a política
+// (FIFO, LRU ou 2Q) guarda e remove blocos individuais, identificados por (id, bloco).
+// Uma prévia ou leitura parcial carrega do disco apenas os blocos que precisa.
+// A política só ordena as chaves; cada bloco fica num buffer imutável compartilhado,
+// devolvido sem cópia em FaixaTexto. Com dedup ativo, o bloco guarda só a referência
+// de chunks e o conteúdo fica no ArmazemChunks, compartilhado entre blocos com trechos iguais;
+// o limite deixa de ser CAPACIDADE_BLOCOS e passa a ser ORCAMENTO_BYTES de memória ocupada.
+class CacheBlocos {
+public:
+    static constexpr size_t TAMANHO_BLOCO = 1024; // Bytes por bloco
+    static constexpr int CAPACIDADE_BLOCOS = 64; // Blocos no cache (~10 textos inteiros)
+    static constexpr int MAX_BLOCOS_TEXTO = 1 << 16; // Limite de blocos por texto na chave
+    static constexpr size_t ORCAMENTO_BYTES = CAPACIDADE_BLOCOS * TAMANHO_BLOCO; // Memória do cache com dedup
+    static constexpr size_t MAX_BYTES_TEXTO = MAX_BLOCOS_TEXTO * TAMANHO_BLOCO; // 64 MiB: além disso as chaves colidiriam
+
+    static inline const string MARCADOR = "*"; // Valor guardado na política: o bloco está em 'entradas'
+
+    // Lê 'tamanho' bytes do texto 'id' a partir de 'inicio' direto do disco
+    using LeitorDisco = function<string(int id, size_t inicio, size_t tamanho)>;
+
+private:
+    AlgoritmoCache* politica; // Política de substituição aplicada aos blocos
+    LeitorDisco leitor_disco; // Caminho lento até o disco
+    Metricas* metricas; // Contadores de hits, misses e remoções
+    bool modo_silencioso; // Controla logs de saída
+    bool dedup; // Guarda os blocos como listas de chunks
+    struct EntradaBloco {
+        shared_ptr<const string> conteudo; // Bytes do bloco (sem dedup)
+        string referencia; // Lista de chunks no armazém (com dedup)
+    };
+
+    ArmazemChunks armazem; // Chunks únicos (só com dedup)
+    unordered_map<int, EntradaBloco> entradas; // Chave do bloco -> conteúdo
+    mutable mutex mutex_cache; // Protege a política e o armazém quando há várias threads
+
+    static int chave(int id, size_t bloco) {
+        return id * MAX_BLOCOS_TEXTO + (int)bloco; // (id, bloco) codificado para as políticas
+    }
+
+    void configurar_politica() {
+        politica->set_modo_silencioso(true); // Logs da política mostrariam chaves codificadas
+        if (dedup) politica->set_capacidade(numeric_limits<int>::max()); // Com dedup o limite é ORCAMENTO_BYTES
+        politica->set_observador_remocao([this](int c, MotivoRemocao motivo) {
+            metricas->registrar_remocao(motivo);
+            soltar_bloco(c); // Chamado dentro da política, já com mutex_cache
+        });
+    }
+
+    void soltar_bloco(int c) {
+        auto it = entradas.find(c);
+        if (it == entradas.end()) return;
+        if (dedup) armazem.liberar(it->second.referencia);
+        entradas.erase(it);
+    }
+
+    // Acrescenta os pedaços do bloco em 'destino' e atualiza a política; false se ausente
+    bool buscar_bloco(int c, vector<FaixaTexto::Pedaco>& destino) {
+        if (politica->buscar_texto(c).empty()) return false;
+        const EntradaBloco& entrada = entradas.at(c);
+        if (!dedup) {
+            destino.push_back({entrada.conteudo, 0, entrada.conteudo->size()});
+            return true;
+        }
+        for (auto& chunk : armazem.pedacos(entrada.referencia)) destino.push_back({chunk, 0, chunk->size()});
+        return true;
+    }
+
+    void guardar_bloco(int c, const shared_ptr<const string>& bloco) {
+        soltar_bloco(c); // Outra thread pode ter carregado o mesmo bloco antes
+        EntradaBloco& entrada = entradas[c];
+        if (dedup) entrada.referencia = armazem.armazenar(*bloco);
+        else entrada.conteudo = bloco;
+        politica->carregar_texto(c, MARCADOR);
+
+        // Com dedup, remove pela ordem da política até caber no orçamento: blocos que
+        // compartilham chunks custam menos, então cabem mais blocos na mesma memória
+        while (dedup && armazem.bytes_ocupados() > ORCAMENTO_BYTES && entradas.size() > 1) {
+            politica->remover_proximo();
+        }
+    }
+
+public:
+    CacheBlocos(AlgoritmoCache* algoritmo, LeitorDisco leitor, Metricas* m, bool usar_dedup = false)
+        : politica(algoritmo), leitor_disco(leitor), metricas(m), modo_silencioso(false), dedup(usar_dedup) {
+        configurar_politica();
+    }
+
+    ~CacheBlocos() {
+        delete politica;
+    }
+
+    void set_politica(AlgoritmoCache* algoritmo) {
+        lock_guard<mutex> trava(mutex_cache);
+        metricas->registrar_remocao(REMOCAO_TROCA_ALGORITMO, politica->get_ids_cache().size());
+        delete politica; // Troca a política e descarta os blocos antigos
+        armazem.limpar();
+        entradas.clear();
+        politica = algoritmo;
+        configurar_politica();
+    }
+
+    void set_modo_silencioso(bool silencioso) {
+        modo_silencioso = silencioso;
+    }
+
+    // Retorna os bytes [inicio, inicio + tamanho) de um texto com 'tamanho_texto' bytes,
+    // como pedaços dos buffers do cache (sem cópia).
+    // cache_hit é true somente se todos os blocos necessários já estavam no cache
+    // (faixa vazia, fora do texto ou texto inexistente não conta como hit).
+    // Textos maiores que MAX_BYTES_TEXTO são lidos só até esse limite.
+    FaixaTexto ler_faixa(int id, size_t inicio, size_t tamanho, size_t tamanho_texto, bool& cache_hit) {
+        FaixaTexto faixa;
+        cache_hit = false;
+        tamanho_texto = min(tamanho_texto, MAX_BYTES_TEXTO); // Bloco além do limite invadiria as chaves do próximo texto
+        if (inicio >= tamanho_texto || tamanho == 0) return faixa;
+        cache_hit = true;
+        size_t fim = inicio + min(tamanho, tamanho_texto - inicio); // Exclusivo
+        size_t primeiro = inicio / TAMANHO_BLOCO;
+        size_t ultimo = (fim - 1) / TAMANHO_BLOCO;
+
+        vector<vector<FaixaTexto::Pedaco>> blocos(ultimo - primeiro + 1);
+        vector<bool> presente(blocos.size(), false);
+        {
+            lock_guard<mutex> trava(mutex_cache);
+            // Do último bloco para o primeiro: o bloco inicial fica como o mais recente da
+            // política, e os prefixos (prévias) são os últimos a sair do cache
+            for (size_t b = ultimo + 1; b-- > primeiro;) {
+                presente[b - primeiro] = buscar_bloco(chave(id, b), blocos[b - primeiro]);
+                if (presente[b - primeiro]) metricas->registrar_hit(id);
+                else metricas->registrar_miss();
+            }
+        }
+
+        // Uma única leitura do disco, do primeiro ao último bloco ausente: um trecho já em
+        // cache no meio sai mais barato relido do que pagando outra espera do disco
+        size_t i = 0; // Primeiro bloco ausente
+        while (i < blocos.size() && presente[i]) i++;
+        if (i < blocos.size()) {
+            size_t j = blocos.size(); // Fim (exclusivo) do último bloco ausente
+            while (presente[j - 1]) j--;
+            cache_hit = false;
+
+            size_t inicio_disco = (primeiro + i) * TAMANHO_BLOCO;
+            size_t fim_disco = min((primeiro + j) * TAMANHO_BLOCO, tamanho_texto);
+            string dados = leitor_disco(id, inicio_disco, fim_disco - inicio_disco);
+
+            lock_guard<mutex> trava(mutex_cache);
+            for (size_t k = j; k-- > i;) { // Do fim para o início, como na busca
+                if (presente[k]) continue; // Já estava no cache: não mexe na ordem da política
+                size_t deslocamento = (k - i) * TAMANHO_BLOCO;
+                if (deslocamento >= dados.size()) continue; // Arquivo encolheu: devolve o que existe
+                auto bloco = make_shared<const string>(dados, deslocamento, TAMANHO_BLOCO);
+                blocos[k].push_back({bloco, 0, bloco->size()});
+                guardar_bloco(chave(id, primeiro + k), bloco);
+            }
+            if (!modo_silencioso) {
+                cout << "💾 Blocos: texto " << id << " [" << primeiro + i << "-" << primeiro + j - 1
+                     << "] carregados do disco" << endl;
+            }
+        }
+
+        for (auto& pedacos : blocos) {
+            faixa.pedacos.insert(faixa.pedacos.end(), pedacos.begin(), pedacos.end());
+        }
+        faixa.recortar(inicio - primeiro * TAMANHO_BLOCO, fim - inicio);
+        return faixa;
+    }
+
+    string resumo_dedup() const {
+        lock_guard<mutex> trava(mutex_cache);
+        if (!dedup) return "Dedup: desativado (use --dedup)";
+        ostringstream saida;
+        saida << "Dedup: " << armazem.bytes_logicos() << " bytes em blocos, " << armazem.bytes_fisicos()
+              << " bytes em " << armazem.num_chunks() << " chunks unicos (+" << armazem.bytes_referencias()
+              << " de referencias, +" << armazem.bytes_controle() << " de controle) | razao "
+              << fixed << setprecision(2) << armazem.razao_dedup() << "x";
+        return saida.str();
+    }
+
+    // Blocos no cache agrupados por texto, na ordem da política: "5:{0,1} 12:{0}"
+    string descrever() const {
+        lock_guard<mutex> trava(mutex_cache);
+        vector<int> chaves = politica->get_ids_cache();
+        vector<pair<int, vector<int>>> por_texto;
+        for (int c : chaves) {
+            int id = c / MAX_BLOCOS_TEXTO;
+            auto it = find_if(por_texto.begin(), por_texto.end(),
+                              [id](const pair<int, vector<int>>& p) { return p.first == id; });
+            if (it == por_texto.end()) {
+                por_texto.push_back({id, {}});
+                it = prev(por_texto.end());
+            }
+            it->second.push_back(c % MAX_BLOCOS_TEXTO);
+        }
+
+        ostringstream saida;
+        saida << "CACHE ATUAL: [";
+        for (size_t i = 0; i < por_texto.size(); i++) {
+            saida << por_texto[i].first << ":{";
+            for (size_t j = 0; j < por_texto[i].second.size(); j++) {
+                saida << por_texto[i].second[j];
+                if (j < por_texto[i].second.size() - 1) saida << ",";
+            }
+            saida << "}";
+            if (i < por_texto.size() - 1) saida << " ";
+        }
+        if (dedup) saida << "] (" << chaves.size() << " blocos, " << armazem.bytes_ocupados() << "/" << ORCAMENTO_BYTES << " bytes)";
+        else saida << "] (" << chaves.size() << "/" << CAPACIDADE_BLOCOS << " blocos)";
+        return saida.str();
+    }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef FAIXA_TEXTO_CPP
+#define FAIXA_TEXTO_CPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+using namespace std;
+
+// Trecho de um texto devolvido pelo cache sem cópia: uma lista de pedaços de buffers
+// imutáveis compartilhados com o cache. Um buffer continua válido mesmo que o bloco
+// saia do cache enquanto a resposta ainda está sendo enviada.
+struct FaixaTexto {
+    struct Pedaco {
+        shared_ptr<const string> buffer; // Bloco (ou chunk, com dedup) guardado no cache
+        size_t inicio; // Primeiro byte usado do buffer
+        size_t tamanho; // Bytes usados a partir de 'inicio'
+    };
+
+    vector<Pedaco> pedacos;
+
+    size_t tamanho() const {
+        size_t total = 0;
+        for (const Pedaco& p : pedacos) total += p.tamanho;
+        return total;
+    }
+
+    // Cópia contígua, para quem precisa de uma string (ex.: prévia no terminal)
+    string juntar() const {
+        string resultado;
+        resultado.reserve(tamanho());
+        for (const Pedaco& p : pedacos) resultado.append(*p.buffer, p.inicio, p.tamanho);
+        return resultado;
+    }
+
+    // Mantém só os bytes [inicio, inicio + tamanho) da faixa, ajustando os pedaços das pontas
+    void recortar(size_t inicio, size_t tamanho) {
+        vector<Pedaco> recortados;
+        size_t posicao = 0; // Início do pedaço atual dentro da faixa
+        for (const Pedaco& p : pedacos) {
+            size_t de = max(posicao, inicio);
+            size_t ate = min(posicao + p.tamanho, inicio + tamanho);
+            if (de < ate) recortados.push_back({p.buffer, p.inicio + (de - posicao), ate - de});
+            posicao += p.tamanho;
+        }
+        pedacos.swap(recortados);
+    }
+};
+
+#endif
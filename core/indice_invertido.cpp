@@ -0,0 +1,389 @@
+#ifndef INDICE_INVERTIDO_CPP
+#define INDICE_INVERTIDO_CPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+// Tokenizador palavra-a-palavra (SWAR): classifica 8 bytes por vez e pula blocos
+// inteiros que são só palavra ou só separador. Letras/dígitos ASCII e bytes UTF-8
+// (>= 0x80) formam palavras; ASCII e maiúsculas latinas (À-Þ) viram minúsculas.
+class Tokenizador {
+private:
+    static constexpr uint64_t UNS = 0x0101010101010101ULL;
+    static constexpr uint64_t ALTOS = 0x8080808080808080ULL;
+    static constexpr size_t TAMANHO_MAX_TERMO = 64; // Termos maiores são truncados
+
+    // Bit 7 de cada byte marcado se lo <= byte <= hi (válido para bytes < 0x80 e também >= 0x80)
+    static uint64_t entre(uint64_t x, uint8_t lo, uint8_t hi) {
+        uint64_t com_alto = x | ALTOS; // Sem empréstimo entre bytes na subtração
+        uint64_t ge_lo = com_alto - UNS * lo;
+        uint64_t gt_hi = com_alto - UNS * (uint64_t)(hi + 1);
+        return ge_lo & ~gt_hi & ALTOS;
+    }
+
+    // Bit 7 de cada byte marcado se o byte faz parte de palavra
+    static uint64_t mascara_palavra(uint64_t x) {
+        uint64_t ascii = ~x & ALTOS; // Só bytes ASCII podem ser dígito/letra
+        uint64_t digitos = entre(x, '0', '9');
+        uint64_t letras = entre(x | (UNS * 0x20), 'a', 'z'); // 0x20 junta maiúsculas e minúsculas
+        return ((digitos | letras) & ascii) | (x & ALTOS);
+    }
+
+    static bool byte_palavra(unsigned char c) {
+        return c >= 0x80 || (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+    }
+
+    static string normalizar(const char* p, size_t n) {
+        string termo(p, min(n, TAMANHO_MAX_TERMO));
+        for (size_t i = 0; i < termo.size(); i++) {
+            unsigned char c = termo[i];
+            if (c >= 'A' && c <= 'Z') {
+                termo[i] = (char)(c | 0x20);
+            } else if (c == 0xC3 && i + 1 < termo.size()) {
+                unsigned char d = termo[i + 1];
+                if (d >= 0x80 && d <= 0x9E && d != 0x97) termo[i + 1] = (char)(d + 0x20); // À-Þ -> à-þ
+                i++;
+            }
+        }
+        return termo;
+    }
+
+public:
+    // Chama 'emitir' para cada termo completo. Se 'continua' for true, a palavra que
+    // encosta no fim dos dados pode seguir no próximo trecho: ela é devolvida em 'resto'.
+    template <typename Emissor>
+    static void tokenizar(const char* dados, size_t tamanho, bool continua, string& resto, Emissor emitir) {
+        size_t pos = 0;
+        size_t inicio_palavra = 0;
+        bool em_palavra = false;
+
+        if (!resto.empty()) {
+            while (pos < tamanho && byte_palavra((unsigned char)dados[pos])) pos++;
+            if (pos == tamanho && continua) {
+                resto.append(dados, tamanho); // A palavra atravessa o trecho inteiro
+                return;
+            }
+            resto.append(dados, pos);
+            emitir(normalizar(resto.data(), resto.size()));
+            resto.clear();
+        }
+
+        while (pos < tamanho) {
+            if (pos + 8 <= tamanho) {
+                uint64_t x;
+                memcpy(&x, dados + pos, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                x = __builtin_bswap64(x); // Byte 0 sempre nos bits menos significativos
+#endif
+                uint64_t mascara = mascara_palavra(x);
+                if ((em_palavra && mascara == ALTOS) || (!em_palavra && mascara == 0)) {
+                    pos += 8; // Nenhuma fronteira de palavra nestes 8 bytes
+                    continue;
+                }
+                for (int i = 0; i < 8; i++, pos++) {
+                    bool palavra = (mascara >> (8 * i + 7)) & 1;
+                    if (palavra && !em_palavra) {
+                        inicio_palavra = pos;
+                        em_palavra = true;
+                    } else if (!palavra && em_palavra) {
+                        emitir(normalizar(dados + inicio_palavra, pos - inicio_palavra));
+                        em_palavra = false;
+                    }
+                }
+                continue;
+            }
+            bool palavra = byte_palavra((unsigned char)dados[pos]);
+            if (palavra && !em_palavra) {
+                inicio_palavra = pos;
+                em_palavra = true;
+            } else if (!palavra && em_palavra) {
+                emitir(normalizar(dados + inicio_palavra, pos - inicio_palavra));
+                em_palavra = false;
+            }
+            pos++;
+        }
+
+        if (em_palavra) {
+            if (continua) resto.assign(dados + inicio_palavra, tamanho - inicio_palavra);
+            else emitir(normalizar(dados + inicio_palavra, tamanho - inicio_palavra));
+        }
+    }
+};
+
+// Lista de textos de um termo: IDs crescentes codificados como delta + varint.
+// A cada INTERVALO_SALTO entradas o ID é gravado inteiro (delta a partir de 0) e
+// registrado na lista de saltos, o que permite pular direto para perto de um alvo.
+class ListaPostings {
+public:
+    static constexpr int INTERVALO_SALTO = 8;
+
+    struct Salto {
+        int id; // ID gravado na posição
+        uint32_t posicao; // Byte onde a entrada começa
+        uint32_t indice; // Número da entrada
+    };
+
+private:
+    vector<uint8_t> dados; // Deltas em varint
+    vector<Salto> saltos; // Pontos de reinício da decodificação
+    uint32_t quantidade = 0; // Total de IDs
+    int ultimo = 0; // Último ID gravado
+
+    void gravar_varint(uint32_t valor) {
+        while (valor >= 0x80) {
+            dados.push_back((uint8_t)(valor | 0x80));
+            valor >>= 7;
+        }
+        dados.push_back((uint8_t)valor);
+    }
+
+public:
+    static uint32_t ler_varint(const vector<uint8_t>& bytes, size_t& pos) {
+        uint32_t valor = 0;
+        int deslocamento = 0;
+        while (true) {
+            uint8_t b = bytes[pos++];
+            valor |= (uint32_t)(b & 0x7F) << deslocamento;
+            if (!(b & 0x80)) return valor;
+            deslocamento += 7;
+        }
+    }
+
+    void adicionar(int id) {
+        if (quantidade > 0 && id <= ultimo) {
+            if (id == ultimo) return;
+            vector<int> ids = decodificar(); // Chegou fora de ordem: reconstrói a lista
+            ids.insert(lower_bound(ids.begin(), ids.end(), id), id);
+            *this = ListaPostings();
+            for (int i : ids) adicionar(i);
+            return;
+        }
+        if (quantidade % INTERVALO_SALTO == 0) {
+            saltos.push_back({id, (uint32_t)dados.size(), quantidade});
+            gravar_varint((uint32_t)id); // Reinício: valor absoluto
+        } else {
+            gravar_varint((uint32_t)(id - ultimo));
+        }
+        ultimo = id;
+        quantidade++;
+    }
+
+    vector<int> decodificar() const {
+        vector<int> ids;
+        ids.reserve(quantidade);
+        size_t pos = 0;
+        int atual = 0;
+        for (uint32_t i = 0; i < quantidade; i++) {
+            if (i % INTERVALO_SALTO == 0) atual = 0;
+            atual += (int)ler_varint(dados, pos);
+            ids.push_back(atual);
+        }
+        return ids;
+    }
+
+    uint32_t tamanho() const { return quantidade; }
+    size_t bytes() const { return dados.size() + saltos.size() * sizeof(Salto); }
+
+    friend class CursorPostings;
+};
+
+// Percorre uma ListaPostings decodificando sob demanda
+class CursorPostings {
+private:
+    const ListaPostings* lista;
+    size_t pos = 0; // Próximo byte a decodificar
+    uint32_t indice = 0; // Índice da entrada atual
+    int atual = 0; // ID atual (válido se !fim())
+    bool terminou = false;
+
+    void ler_entrada() {
+        if (indice >= lista->quantidade) {
+            terminou = true;
+            return;
+        }
+        if (indice % ListaPostings::INTERVALO_SALTO == 0) atual = 0;
+        atual += (int)ListaPostings::ler_varint(lista->dados, pos);
+    }
+
+public:
+    explicit CursorPostings(const ListaPostings* l) : lista(l) {
+        ler_entrada();
+    }
+
+    bool fim() const { return terminou; }
+    int id() const { return atual; }
+
+    void avancar() {
+        indice++;
+        ler_entrada();
+    }
+
+    // Avança até o primeiro ID >= alvo, usando os saltos para evitar decodificar tudo
+    void avancar_ate(int alvo) {
+        if (terminou || atual >= alvo) return;
+        const auto& saltos = lista->saltos;
+        auto it = upper_bound(saltos.begin(), saltos.end(), alvo,
+                              [](int a, const ListaPostings::Salto& s) { return a < s.id; });
+        if (it != saltos.begin()) {
+            const auto& salto = *prev(it); // Último salto com id <= alvo
+            if (salto.indice > indice) {
+                pos = salto.posicao;
+                indice = salto.indice;
+                ler_entrada();
+            }
+        }
+        while (!terminou && atual < alvo) avancar();
+    }
+};
+
+// Índice invertido termo -> textos, alimentado pelos trechos que passam pela leitura do disco.
+// Um texto entra no índice quando todos os seus bytes foram vistos em ordem; trechos que
+// pulam adiante são ignorados até que a leitura sequencial os alcance.
+class IndiceInvertido {
+private:
+    // Estado de um texto ainda sendo tokenizado
+    struct TextoEmAndamento {
+        size_t proximo_byte = 0; // Primeiro byte ainda não tokenizado
+        string resto; // Palavra cortada no fim do último trecho
+        unordered_set<string> termos; // Termos vistos até agora
+    };
+
+    unordered_map<string, ListaPostings> postings; // Termo -> textos
+    unordered_map<int, TextoEmAndamento> em_andamento; // Textos parcialmente lidos
+    unordered_set<int> indexados; // Textos completos no índice
+    mutable shared_mutex mutex_indice; // Consultas compartilhadas, alimentação exclusiva
+
+    void concluir_texto(int id, TextoEmAndamento& estado) {
+        for (const string& termo : estado.termos) {
+            postings[termo].adicionar(id);
+        }
+        indexados.insert(id);
+    }
+
+public:
+    // Recebe os bytes [inicio, inicio + dados.size()) do texto 'id', que tem 'tamanho_texto' bytes
+    void alimentar(int id, size_t inicio, const string& dados, size_t tamanho_texto) {
+        unique_lock<shared_mutex> trava(mutex_indice);
+        if (indexados.count(id)) return;
+
+        TextoEmAndamento& estado = em_andamento[id];
+        size_t fim = inicio + dados.size();
+        if (inicio > estado.proximo_byte || fim <= estado.proximo_byte) return; // Lacuna ou já visto
+
+        size_t pular = estado.proximo_byte - inicio;
+        bool continua = fim < tamanho_texto;
+        Tokenizador::tokenizar(dados.data() + pular, dados.size() - pular, continua, estado.resto,
+                               [&estado](string termo) { estado.termos.insert(move(termo)); });
+        estado.proximo_byte = fim;
+
+        if (!continua) {
+            concluir_texto(id, estado);
+            em_andamento.erase(id);
+        }
+    }
+
+    // Texto vazio ou inexistente: entra no índice sem nenhum termo
+    void marcar_vazio(int id) {
+        unique_lock<shared_mutex> trava(mutex_indice);
+        em_andamento.erase(id);
+        indexados.insert(id);
+    }
+
+    bool texto_indexado(int id) const {
+        shared_lock<shared_mutex> trava(mutex_indice);
+        return indexados.count(id) > 0;
+    }
+
+    size_t textos_indexados() const {
+        shared_lock<shared_mutex> trava(mutex_indice);
+        return indexados.size();
+    }
+
+    // Textos que contêm todas as palavras (todas = true) ou qualquer uma delas
+    vector<int> buscar(const string& consulta, bool todas) const {
+        vector<string> termos;
+        string resto;
+        Tokenizador::tokenizar(consulta.data(), consulta.size(), false, resto,
+                               [&termos](string termo) { termos.push_back(move(termo)); });
+        sort(termos.begin(), termos.end());
+        termos.erase(unique(termos.begin(), termos.end()), termos.end());
+        if (termos.empty()) return {};
+
+        shared_lock<shared_mutex> trava(mutex_indice);
+        vector<const ListaPostings*> listas;
+        for (const string& termo : termos) {
+            auto it = postings.find(termo);
+            if (it != postings.end()) listas.push_back(&it->second);
+            else if (todas) return {}; // Termo ausente: interseção vazia
+        }
+        if (listas.empty()) return {};
+        return todas ? intersecao(listas) : uniao(listas);
+    }
+
+    // Termos distintos e bytes ocupados pelas listas
+    pair<size_t, size_t> get_tamanho() const {
+        shared_lock<shared_mutex> trava(mutex_indice);
+        size_t bytes = 0;
+        for (const auto& par : postings) bytes += par.first.size() + par.second.bytes();
+        return {postings.size(), bytes};
+    }
+
+private:
+    static vector<int> intersecao(vector<const ListaPostings*> listas) {
+        sort(listas.begin(), listas.end(),
+             [](const ListaPostings* a, const ListaPostings* b) { return a->tamanho() < b->tamanho(); });
+        vector<CursorPostings> cursores;
+        for (const auto* lista : listas) cursores.emplace_back(lista);
+
+        vector<int> resultado;
+        CursorPostings& guia = cursores[0]; // Menor lista conduz a interseção
+        while (!guia.fim()) {
+            int alvo = guia.id();
+            bool em_todas = true;
+            for (size_t i = 1; i < cursores.size(); i++) {
+                cursores[i].avancar_ate(alvo);
+                if (cursores[i].fim()) return resultado;
+                if (cursores[i].id() != alvo) {
+                    em_todas = false;
+                    guia.avancar_ate(cursores[i].id()); // Salta a guia para o próximo candidato
+                    break;
+                }
+            }
+            if (em_todas) {
+                resultado.push_back(alvo);
+                guia.avancar();
+            }
+        }
+        return resultado;
+    }
+
+    static vector<int> uniao(const vector<const ListaPostings*>& listas) {
+        vector<CursorPostings> cursores;
+        for (const auto* lista : listas) cursores.emplace_back(lista);
+
+        vector<int> resultado;
+        while (true) {
+            int menor = -1;
+            for (const auto& c : cursores) {
+                if (!c.fim() && (menor < 0 || c.id() < menor)) menor = c.id();
+            }
+            if (menor < 0) return resultado;
+            resultado.push_back(menor);
+            for (auto& c : cursores) {
+                if (!c.fim() && c.id() == menor) c.avancar();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef METRICAS_CPP
+#define METRICAS_CPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <cstdint>
+#include "../algorithms/algoritmo_cache.cpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace std;
+
+// Quem pediu a leitura do disco: o cache (miss) ou o indexador em segundo plano
+enum OrigemLeitura {
+    LEITURA_CACHE,
+    LEITURA_INDICE,
+    NUM_ORIGENS_LEITURA
+};
+
+// Contagem aproximada dos IDs mais acessados (algoritmo Space-Saving): mantém no máximo
+// CAPACIDADE contadores; um ID novo substitui o menor e herda a contagem dele como erro.
+class SketchTopK {
+public:
+    static constexpr size_t CAPACIDADE = 32;
+
+    struct Contador {
+        int id;
+        uint64_t contagem; // Limite superior da contagem real
+        uint64_t erro; // Quanto da contagem pode ter sido herdado
+    };
+
+private:
+    vector<Contador> contadores;
+
+public:
+    void registrar(int id) {
+        for (auto& c : contadores) {
+            if (c.id == id) {
+                c.contagem++;
+                return;
+            }
+        }
+        if (contadores.size() < CAPACIDADE) {
+            contadores.push_back({id, 1, 0});
+            return;
+        }
+        auto menor = min_element(contadores.begin(), contadores.end(),
+                                 [](const Contador& a, const Contador& b) { return a.contagem < b.contagem; });
+        *menor = {id, menor->contagem + 1, menor->contagem};
+    }
+
+    const vector<Contador>& get_contadores() const {
+        return contadores;
+    }
+};
+
+// Texto do top-K: a contagem real difere de 'hits' por no máximo 'erro'
+struct TextoTop {
+    int id;
+    uint64_t hits; // Soma das contagens do texto nas fatias que o acompanham
+    uint64_t erro; // Contagem herdada nessas fatias + o que pode ter ficado nas fatias que o perderam
+};
+
+// Cópia consistente o bastante dos contadores, somando todas as fatias
+struct FotoMetricas {
+    static constexpr int NUM_BALDES = 24; // Balde i: latência <= 2^i µs (último: acima disso)
+
+    uint64_t hits = 0; // Blocos encontrados no cache
+    uint64_t misses = 0; // Blocos que precisaram do disco
+    uint64_t remocoes[NUM_MOTIVOS_REMOCAO] = {}; // Remoções por motivo
+    uint64_t bytes_carregados[NUM_ORIGENS_LEITURA] = {}; // Bytes lidos do disco, por origem
+    uint64_t leituras_disco[NUM_ORIGENS_LEITURA] = {}; // Leituras do disco, por origem
+    uint64_t latencia_total_us[NUM_ORIGENS_LEITURA] = {}; // Soma das latências de leitura
+    uint64_t histograma[NUM_ORIGENS_LEITURA][NUM_BALDES] = {}; // Leituras por balde de latência
+    vector<TextoTop> top_textos; // Textos mais acessados
+};
+
+// Métricas sempre ativas do cache. Cada núcleo escreve na sua fatia, alinhada em linha de
+// cache, com contadores atômicos relaxados; a foto soma as fatias sem parar quem escreve.
+class Metricas {
+public:
+    static constexpr int NUM_FATIAS = 16;
+    static constexpr size_t TOP_K = 10;
+
+private:
+    struct alignas(64) Fatia {
+        atomic<uint64_t> hits{0};
+        atomic<uint64_t> misses{0};
+        atomic<uint64_t> remocoes[NUM_MOTIVOS_REMOCAO] = {};
+        atomic<uint64_t> bytes_carregados[NUM_ORIGENS_LEITURA] = {};
+        atomic<uint64_t> leituras_disco[NUM_ORIGENS_LEITURA] = {};
+        atomic<uint64_t> latencia_total_us[NUM_ORIGENS_LEITURA] = {};
+        atomic<uint64_t> histograma[NUM_ORIGENS_LEITURA][FotoMetricas::NUM_BALDES] = {};
+        mutex mutex_sketch; // Quase sem disputa: só threads no mesmo núcleo
+        SketchTopK sketch; // Hits por texto nesta fatia
+    };
+
+    Fatia fatias[NUM_FATIAS];
+
+    // Thread de exportação periódica
+    thread exportador;
+    mutex mutex_exportador;
+    condition_variable aviso_parada;
+    bool parar_exportacao_flag = false;
+
+    Fatia& fatia_atual() {
+#ifdef __linux__
+        int cpu = sched_getcpu();
+        if (cpu >= 0) return fatias[cpu % NUM_FATIAS];
+#endif
+        static thread_local size_t indice = hash<thread::id>()(this_thread::get_id()) % NUM_FATIAS;
+        return fatias[indice];
+    }
+
+    // Microssegundos como segundos em decimal exato: 1048576 -> "1.048576"
+    static string segundos_exatos(uint64_t us) {
+        string fracao = to_string(us % 1000000);
+        fracao.insert(0, 6 - fracao.size(), '0');
+        while (!fracao.empty() && fracao.back() == '0') fracao.pop_back();
+        return to_string(us / 1000000) + (fracao.empty() ? "" : "." + fracao);
+    }
+
+    static int balde_latencia(uint64_t us) {
+        int balde = 0;
+        while (balde < FotoMetricas::NUM_BALDES - 1 && us > (1ULL << balde)) balde++; // Mesmo sentido do "le" do Prometheus
+        return balde;
+    }
+
+public:
+    Metricas() = default;
+
+    ~Metricas() {
+        parar_exportacao();
+    }
+
+    static const char* nome_motivo(MotivoRemocao motivo) {
+        switch (motivo) {
+            case REMOCAO_MAIS_ANTIGO: return "mais_antigo";
+            case REMOCAO_MENOS_RECENTE: return "menos_recente";
+            case REMOCAO_2Q_ENTRADA: return "2q_entrada";
+            case REMOCAO_2Q_FREQUENTE: return "2q_frequente";
+            case REMOCAO_TROCA_ALGORITMO: return "troca_algoritmo";
+            default: return "desconhecido";
+        }
+    }
+
+    static const char* nome_origem(OrigemLeitura origem) {
+        return origem == LEITURA_CACHE ? "cache" : "indice";
+    }
+
+    // O sketch é protegido por um mutex da fatia: quase sempre livre (só threads no mesmo
+    // núcleo disputam), mas é o único custo por hit além de um incremento atômico
+    void registrar_hit(int id) {
+        Fatia& f = fatia_atual();
+        f.hits.fetch_add(1, memory_order_relaxed);
+        lock_guard<mutex> trava(f.mutex_sketch);
+        f.sketch.registrar(id);
+    }
+
+    void registrar_miss() {
+        fatia_atual().misses.fetch_add(1, memory_order_relaxed);
+    }
+
+    void registrar_remocao(MotivoRemocao motivo, uint64_t quantidade = 1) {
+        fatia_atual().remocoes[motivo].fetch_add(quantidade, memory_order_relaxed);
+    }
+
+    void registrar_leitura_disco(OrigemLeitura origem, uint64_t bytes, chrono::steady_clock::duration duracao) {
+        uint64_t us = (uint64_t)chrono::duration_cast<chrono::microseconds>(duracao).count();
+        Fatia& f = fatia_atual();
+        f.bytes_carregados[origem].fetch_add(bytes, memory_order_relaxed);
+        f.leituras_disco[origem].fetch_add(1, memory_order_relaxed);
+        f.latencia_total_us[origem].fetch_add(us, memory_order_relaxed);
+        f.histograma[origem][balde_latencia(us)].fetch_add(1, memory_order_relaxed);
+    }
+
+    FotoMetricas capturar() {
+        FotoMetricas foto;
+        unordered_map<int, TextoTop> por_texto;
+        vector<unordered_set<int>> ids_fatia(NUM_FATIAS); // IDs acompanhados por cada fatia
+        uint64_t minimo_fatia[NUM_FATIAS] = {}; // Teto da contagem de um ID ausente em fatia cheia
+        int indice_fatia = 0;
+        for (Fatia& f : fatias) {
+            foto.hits += f.hits.load(memory_order_relaxed);
+            foto.misses += f.misses.load(memory_order_relaxed);
+            for (int m = 0; m < NUM_MOTIVOS_REMOCAO; m++) foto.remocoes[m] += f.remocoes[m].load(memory_order_relaxed);
+            for (int o = 0; o < NUM_ORIGENS_LEITURA; o++) {
+                foto.bytes_carregados[o] += f.bytes_carregados[o].load(memory_order_relaxed);
+                foto.leituras_disco[o] += f.leituras_disco[o].load(memory_order_relaxed);
+                foto.latencia_total_us[o] += f.latencia_total_us[o].load(memory_order_relaxed);
+                for (int b = 0; b < FotoMetricas::NUM_BALDES; b++) foto.histograma[o][b] += f.histograma[o][b].load(memory_order_relaxed);
+            }
+
+            lock_guard<mutex> trava(f.mutex_sketch);
+            const auto& contadores = f.sketch.get_contadores();
+            for (const auto& c : contadores) {
+                TextoTop& t = por_texto.emplace(c.id, TextoTop{c.id, 0, 0}).first->second;
+                t.hits += c.contagem;
+                t.erro += c.erro;
+                ids_fatia[indice_fatia].insert(c.id);
+            }
+            if (contadores.size() == SketchTopK::CAPACIDADE) {
+                for (const auto& c : contadores) {
+                    if (minimo_fatia[indice_fatia] == 0 || c.contagem < minimo_fatia[indice_fatia]) minimo_fatia[indice_fatia] = c.contagem;
+                }
+            }
+            indice_fatia++;
+        }
+        for (auto& [id, t] : por_texto) {
+            for (int i = 0; i < NUM_FATIAS; i++) {
+                if (!ids_fatia[i].count(id)) t.erro += minimo_fatia[i]; // Fatia cheia pode ter descartado o ID
+            }
+            foto.top_textos.push_back(t);
+        }
+        sort(foto.top_textos.begin(), foto.top_textos.end(),
+             [](const TextoTop& a, const TextoTop& b) {
+                 return a.hits != b.hits ? a.hits > b.hits : a.id < b.id;
+             });
+        if (foto.top_textos.size() > TOP_K) foto.top_textos.resize(TOP_K);
+        return foto;
+    }
+
+    // Formato de texto do Prometheus (node_exporter textfile collector)
+    static string formato_prometheus(const FotoMetricas& foto) {
+        ostringstream saida;
+        saida << "# HELP ra2_cache_hits_total Blocos encontrados no cache.\n"
+              << "# TYPE ra2_cache_hits_total counter\n"
+              << "ra2_cache_hits_total " << foto.hits << "\n"
+              << "# HELP ra2_cache_misses_total Blocos que precisaram ser lidos do disco.\n"
+              << "# TYPE ra2_cache_misses_total counter\n"
+              << "ra2_cache_misses_total " << foto.misses << "\n"
+              << "# HELP ra2_cache_remocoes_total Blocos removidos do cache, por motivo.\n"
+              << "# TYPE ra2_cache_remocoes_total counter\n";
+        for (int m = 0; m < NUM_MOTIVOS_REMOCAO; m++) {
+            saida << "ra2_cache_remocoes_total{motivo=\"" << nome_motivo((MotivoRemocao)m) << "\"} "
+                  << foto.remocoes[m] << "\n";
+        }
+        saida << "# HELP ra2_disco_bytes_total Bytes lidos do disco, por origem (cache: misses; indice: indexador).\n"
+              << "# TYPE ra2_disco_bytes_total counter\n";
+        for (int o = 0; o < NUM_ORIGENS_LEITURA; o++) {
+            saida << "ra2_disco_bytes_total{origem=\"" << nome_origem((OrigemLeitura)o) << "\"} "
+                  << foto.bytes_carregados[o] << "\n";
+        }
+        saida << "# HELP ra2_disco_latencia_segundos Latencia das leituras do disco, por origem.\n"
+              << "# TYPE ra2_disco_latencia_segundos histogram\n";
+        for (int o = 0; o < NUM_ORIGENS_LEITURA; o++) {
+            string origem = string("origem=\"") + nome_origem((OrigemLeitura)o) + "\"";
+            uint64_t acumulado = 0;
+            for (int b = 0; b < FotoMetricas::NUM_BALDES - 1; b++) {
+                acumulado += foto.histograma[o][b];
+                saida << "ra2_disco_latencia_segundos_bucket{" << origem << ",le=\"" << segundos_exatos(1ULL << b)
+                      << "\"} " << acumulado << "\n";
+            }
+            saida << "ra2_disco_latencia_segundos_bucket{" << origem << ",le=\"+Inf\"} " << foto.leituras_disco[o] << "\n"
+                  << "ra2_disco_latencia_segundos_sum{" << origem << "} " << segundos_exatos(foto.latencia_total_us[o]) << "\n"
+                  << "ra2_disco_latencia_segundos_count{" << origem << "} " << foto.leituras_disco[o] << "\n";
+        }
+        saida << "# HELP ra2_texto_hits Hits aproximados dos textos mais acessados (Space-Saving).\n"
+              << "# TYPE ra2_texto_hits gauge\n";
+        for (const auto& t : foto.top_textos) {
+            saida << "ra2_texto_hits{id=\"" << t.id << "\"} " << t.hits << "\n";
+        }
+        saida << "# HELP ra2_texto_hits_erro Diferenca maxima entre ra2_texto_hits e a contagem real.\n"
+              << "# TYPE ra2_texto_hits_erro gauge\n";
+        for (const auto& t : foto.top_textos) {
+            saida << "ra2_texto_hits_erro{id=\"" << t.id << "\"} " << t.erro << "\n";
+        }
+        return saida.str();
+    }
+
+    // Grava a foto em 'caminho' a cada 'intervalo'; o arquivo é trocado de uma vez (rename)
+    void iniciar_exportacao(const string& caminho, chrono::seconds intervalo) {
+        parar_exportacao();
+        parar_exportacao_flag = false;
+        exportador = thread([this, caminho, intervalo]() {
+            unique_lock<mutex> trava(mutex_exportador);
+            while (!parar_exportacao_flag) {
+                exportar(caminho);
+                aviso_parada.wait_for(trava, intervalo, [this]() { return parar_exportacao_flag; });
+            }
+            exportar(caminho); // Última foto ao encerrar
+        });
+    }
+
+    void parar_exportacao() {
+        {
+            lock_guard<mutex> trava(mutex_exportador);
+            parar_exportacao_flag = true;
+        }
+        aviso_parada.notify_all();
+        if (exportador.joinable()) exportador.join();
+    }
+
+    bool exportar(const string& caminho) {
+        error_code erro;
+        filesystem::path destino(caminho);
+        if (destino.has_parent_path()) filesystem::create_directories(destino.parent_path(), erro);
+
+        string temporario = caminho + ".tmp";
+        {
+            ofstream arquivo(temporario);
+            if (!arquivo.is_open()) return false;
+            arquivo << formato_prometheus(capturar());
+        }
+        filesystem::rename(temporario, destino, erro);
+        return !erro;
+    }
+};
+
+#endif
@@ -4,78 +4,157 @@
 #include <chrono>
 #include <thread>
 #include <fstream>
+#include <sstream>
+#include <atomic>
+#include <limits>
 
 #include "algorithms/algoritmo_cache.cpp"
 #include "algorithms/cache_fifo.cpp"
 #include "algorithms/cache_lru.cpp"
 #include "algorithms/cache_2q.cpp"
 #include "simulation/simulador.cpp"
+#include "core/cache_blocos.cpp"
+#include "core/indice_invertido.cpp"
+#include "server/servidor_cache.cpp"
 
 using namespace std;
 
 class GerenciadorTextos {
 private:
+    static const size_t TAMANHO_PREVIA = CacheBlocos::TAMANHO_BLOCO; // Bytes lidos para a prévia
+
     vector<string> caminhos_textos; // Lista de caminhos para os textos
-    AlgoritmoCache* algoritmo_cache; // Ponteiro para o algoritmo de cache atual
+    vector<size_t> tamanhos_textos; // Tamanho em bytes de cada texto
+    CacheBlocos* cache_blocos; // Cache por blocos com o algoritmo atual
     string algoritmo_atual; // Nome do algoritmo de cache em uso
+    Metricas metricas; // Contadores sempre ativos, exportados em docs/metricas.prom
+    IndiceInvertido indice; // Palavra -> textos, alimentado pelas leituras do disco
+    thread indexador; // Lê em segundo plano os textos que ainda faltam no índice
+    atomic<bool> parar_indexador; // Interrompe a indexação ao encerrar
+
+    // Descarta um caractere UTF-8 incompleto no fim do texto, sem tocar nos completos
+    static void cortar_utf8_incompleto(string& texto) {
+        size_t inicio = texto.size(); // Recua sobre até 3 bytes de continuação (10xxxxxx)
+        while (inicio > 0 && texto.size() - inicio < 3 && (texto[inicio - 1] & 0xC0) == 0x80) inicio--;
+        if (inicio == 0) return;
+        unsigned char lider = texto[inicio - 1];
+        size_t esperado = lider >= 0xF0 ? 4 : lider >= 0xE0 ? 3 : lider >= 0xC0 ? 2 : 1;
+        if (texto.size() - (inicio - 1) < esperado) texto.resize(inicio - 1);
+    }
 
 public:
-    GerenciadorTextos() : algoritmo_atual("FIFO") {
+    GerenciadorTextos(bool dedup = false) : algoritmo_atual("FIFO"), parar_indexador(false) {
         carregar_lista_textos(); // Inicializa a lista de caminhos
-        algoritmo_cache = new CacheFIFO(); // Define FIFO como padrão
+        cache_blocos = new CacheBlocos(new CacheFIFO(CacheBlocos::CAPACIDADE_BLOCOS), // Define FIFO como padrão
+            [this](int id, size_t inicio, size_t tamanho) { return carregar_faixa_disco(id, inicio, tamanho, LEITURA_CACHE); },
+            &metricas, dedup);
+        metricas.iniciar_exportacao("docs/metricas.prom", chrono::seconds(5));
+        indexador = thread(&GerenciadorTextos::indexar_corpus, this);
     }
 
     ~GerenciadorTextos() {
-        delete algoritmo_cache; // Libera memória do algoritmo atual
+        parar_indexador = true;
+        indexador.join();
+        metricas.parar_exportacao();
+        delete cache_blocos; // Libera memória do cache e do algoritmo atual
     }
 
     void set_algoritmo_cache(AlgoritmoCache* algoritmo, const string& nome) {
-        delete algoritmo_cache; // Substitui o algoritmo atual
-        algoritmo_cache = algoritmo;
+        cache_blocos->set_politica(algoritmo); // Substitui o algoritmo atual
         algoritmo_atual = nome;
         cout << "Algoritmo trocado para: " << nome << endl;
     }
 
     void carregar_lista_textos() {
         caminhos_textos.resize(100); // Inicializa lista com 100 textos
+        tamanhos_textos.resize(100);
         for (int i = 0; i < 100; i++) {
             caminhos_textos[i] = "texts/" + to_string(i + 1) + ".txt";
+            ifstream arquivo(caminhos_textos[i], ios::binary | ios::ate); // Só metadados, sem ler o conteúdo
+            tamanhos_textos[i] = arquivo.is_open() ? (size_t)arquivo.tellg() : 0;
         }
     }
 
-    string carregar_texto_disco(int id) {
+    size_t tamanho_texto(int id) const {
+        return (id >= 1 && id <= 100) ? tamanhos_textos[id - 1] : 0;
+    }
+
+    // Lê apenas a faixa pedida do arquivo. Toda leitura do disco entra nas métricas, separada por origem
+    string carregar_faixa_disco(int id, size_t inicio, size_t tamanho, OrigemLeitura origem) {
+        auto inicio_leitura = chrono::steady_clock::now();
         this_thread::sleep_for(chrono::milliseconds(100)); // Simula atraso de leitura
-        
-        if (id >= 1 && id <= 100) {
-            string caminho = caminhos_textos[id - 1];
-            ifstream arquivo(caminho);
-            
-            if (arquivo.is_open()) {
-                string conteudo;
-                string linha;
-                while (getline(arquivo, linha)) {
-                    conteudo += linha + "\n"; // Concatena linhas do arquivo
-                }
-                arquivo.close();
-                return conteudo.empty() ? "Arquivo vazio!" : conteudo;
-            }
-            return "Arquivo nao encontrado!";
+
+        ifstream arquivo(caminhos_textos[id - 1], ios::binary);
+        if (!arquivo.is_open()) {
+            metricas.registrar_leitura_disco(origem, 0, chrono::steady_clock::now() - inicio_leitura);
+            return "";
         }
-        return "Texto nao encontrado!";
+        string conteudo(tamanho, '\0');
+        arquivo.seekg(inicio);
+        arquivo.read(&conteudo[0], tamanho);
+        conteudo.resize(arquivo.gcount()); // Arquivo pode ter encolhido
+        metricas.registrar_leitura_disco(origem, conteudo.size(), chrono::steady_clock::now() - inicio_leitura);
+        indice.alimentar(id, inicio, conteudo, tamanho_texto(id)); // Indexa o que passou pelo disco
+        return conteudo;
     }
 
-    void mostrar_cache() {
-        if (algoritmo_cache) {
-            vector<int> ids_cache = algoritmo_cache->get_ids_cache(); // Obtém IDs no cache
-            cout << "CACHE ATUAL: [";
-            for (size_t i = 0; i < ids_cache.size(); i++) {
-                cout << ids_cache[i];
-                if (i < ids_cache.size() - 1) cout << ", ";
+    // Completa o índice lendo do disco, sem passar pelo cache, os textos ainda não vistos por inteiro
+    void indexar_corpus() {
+        for (int id = 1; id <= 100 && !parar_indexador; id++) {
+            if (indice.texto_indexado(id)) continue;
+            if (tamanho_texto(id) == 0 || carregar_faixa_disco(id, 0, tamanho_texto(id), LEITURA_INDICE).empty()) {
+                indice.marcar_vazio(id); // Inexistente ou vazio: conta na cobertura, sem termos
             }
-            cout << "] (" << ids_cache.size() << "/10)" << endl;
         }
     }
 
+    // Consulta só o índice: não toca o cache nem o disco
+    string resultado_busca(const string& consulta, bool todas) {
+        vector<int> ids = indice.buscar(consulta, todas);
+        ostringstream saida;
+        for (size_t i = 0; i < ids.size(); i++) {
+            saida << ids[i];
+            if (i < ids.size() - 1) saida << " ";
+        }
+        return saida.str();
+    }
+
+    void buscar_palavras(const string& linha) {
+        auto inicio = chrono::steady_clock::now();
+
+        // "a b c" busca textos com todas as palavras; "a OR b" com qualquer uma
+        istringstream entrada(linha);
+        string palavra, consulta;
+        bool todas = true;
+        while (entrada >> palavra) {
+            if (palavra == "OR") todas = false;
+            else consulta += palavra + " ";
+        }
+        string ids = resultado_busca(consulta, todas);
+
+        auto duracao = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - inicio);
+        cout << "Textos encontrados (" << (todas ? "todas as palavras" : "qualquer palavra") << "): ["
+             << ids << "]" << endl;
+        cout << "Tempo: " << duracao.count() << "us | Indice cobre " << indice.textos_indexados()
+             << "/100 textos" << endl;
+    }
+
+    void set_modo_silencioso(bool silencioso) {
+        cache_blocos->set_modo_silencioso(silencioso); // Sem logs por requisição no modo servidor
+    }
+
+    // Bytes [inicio, inicio + tamanho) do texto, carregando do disco só os blocos ausentes.
+    // Seguro para várias threads; retorna false se o ID for inválido.
+    bool obter_faixa(int id, size_t inicio, size_t tamanho, FaixaTexto& faixa, bool& cache_hit) {
+        if (id < 1 || id > 100) return false;
+        faixa = cache_blocos->ler_faixa(id, inicio, tamanho, tamanho_texto(id), cache_hit);
+        return true;
+    }
+
+    void mostrar_cache() {
+        cout << cache_blocos->descrever() << endl;
+    }
+
     void abrir_texto(int id) {
         auto inicio = chrono::steady_clock::now(); // Marca início da operação
         
@@ -84,27 +163,16 @@ public:
             return;
         }
 
-        string conteudo;
+        FaixaTexto faixa;
         bool cache_hit = false;
+        obter_faixa(id, 0, TAMANHO_PREVIA, faixa, cache_hit); // Só os blocos da prévia
+        string conteudo = faixa.juntar();
+        cortar_utf8_incompleto(conteudo); // A prévia termina no fim de um bloco
 
-        if (algoritmo_cache) {
-            conteudo = algoritmo_cache->buscar_texto(id); // Tenta buscar no cache
-            if (!conteudo.empty()) {
-                cache_hit = true;
-                cout << "[CACHE HIT] Texto " << id << " do cache!" << endl;
-            }
-        }
-
-        if (!cache_hit) {
-            cout << "[CACHE MISS] Carregando texto " << id << " do disco..." << endl;
-            string conteudo_disco = carregar_texto_disco(id);
-            
-            if (algoritmo_cache) {
-                algoritmo_cache->carregar_texto(id, conteudo_disco); // Carrega no cache
-                conteudo = algoritmo_cache->buscar_texto(id);
-            } else {
-                conteudo = conteudo_disco;
-            }
+        if (cache_hit) {
+            cout << "[CACHE HIT] Texto " << id << " do cache!" << endl;
+        } else {
+            cout << "[CACHE MISS] Texto " << id << " carregado do disco" << endl;
         }
         
         cout << "Texto " << id << " (primeiras linhas):" << endl;
@@ -114,12 +182,13 @@ public:
         int linhas_mostradas = 0;
         while (pos < conteudo.length() && linhas_mostradas < 3) {
             size_t newline = conteudo.find('\n', pos);
-            if (newline == string::npos) break;
+            if (newline == string::npos) newline = conteudo.length(); // Linha continua após a prévia
             cout << conteudo.substr(pos, newline - pos) << endl; // Mostra até 3 linhas
             pos = newline + 1;
             linhas_mostradas++;
         }
-        if (linhas_mostradas == 3) cout << "... [truncado]" << endl;
+        if (conteudo.empty()) cout << "Arquivo vazio ou nao encontrado!" << endl;
+        else if (linhas_mostradas == 3 || tamanho_texto(id) > TAMANHO_PREVIA) cout << "... [truncado]" << endl;
         
         cout << "==========================================" << endl;
 
@@ -139,43 +208,111 @@ public:
         
         cout << "\nTrocando para algoritmo: " << algoritmo_vencedor << endl;
         if (algoritmo_vencedor == "FIFO") {
-            set_algoritmo_cache(new CacheFIFO(), "FIFO");
+            set_algoritmo_cache(new CacheFIFO(CacheBlocos::CAPACIDADE_BLOCOS), "FIFO");
         } else if (algoritmo_vencedor == "LRU") {
-            set_algoritmo_cache(new CacheLRU(), "LRU");
+            set_algoritmo_cache(new CacheLRU(CacheBlocos::CAPACIDADE_BLOCOS), "LRU");
         } else if (algoritmo_vencedor == "2Q") {
-            set_algoritmo_cache(new Cache2Q(), "2Q");
+            set_algoritmo_cache(new Cache2Q(CacheBlocos::CAPACIDADE_BLOCOS), "2Q");
         }
         
         cout << "Agora usando: " << algoritmo_atual << " (mais rapido)" << endl;
     }
 
-    void mostrar_estatisticas() {
-        if (algoritmo_cache) {
-            auto stats = algoritmo_cache->get_estatisticas();
-            int hits = stats.first;
-            int misses = stats.second;
-            
-            cout << "\nESTATISTICAS ATUAIS:" << endl;
-            cout << "Algoritmo: " << algoritmo_atual << endl;
-            cout << "Hits: " << hits << " | Misses: " << misses << endl;
-            cout << "Taxa de acerto: " << (hits * 100.0 / max(1, hits + misses)) << "%" << endl;
-            mostrar_cache();
+    string resumo_estatisticas() {
+        FotoMetricas foto = metricas.capturar();
+        uint64_t total = foto.hits + foto.misses;
+        uint64_t remocoes = 0;
+        for (uint64_t r : foto.remocoes) remocoes += r;
+
+        ostringstream saida;
+        saida << "Algoritmo: " << algoritmo_atual << "\n";
+        saida << "Hits: " << foto.hits << " | Misses: " << foto.misses << " (por bloco de " << CacheBlocos::TAMANHO_BLOCO << " bytes)\n";
+        saida << "Taxa de acerto: " << (foto.hits * 100.0 / max<uint64_t>(1, total)) << "%\n";
+        saida << "Remocoes: " << remocoes << " | Lido do disco pelo cache: " << foto.bytes_carregados[LEITURA_CACHE]
+              << " bytes em " << foto.leituras_disco[LEITURA_CACHE] << " leituras\n";
+        saida << "Lido do disco pelo indexador: " << foto.bytes_carregados[LEITURA_INDICE] << " bytes em "
+              << foto.leituras_disco[LEITURA_INDICE] << " leituras\n";
+        saida << "Textos mais acessados:";
+        for (const auto& t : foto.top_textos) {
+            saida << " " << t.id << "(" << t.hits;
+            if (t.erro > 0) saida << "±" << t.erro;
+            saida << ")";
         }
+        saida << "\n";
+        saida << cache_blocos->descrever() << "\n";
+        saida << cache_blocos->resumo_dedup() << "\n";
+        auto tamanho_indice = indice.get_tamanho();
+        saida << "Indice: " << indice.textos_indexados() << "/100 textos, " << tamanho_indice.first
+              << " termos, " << tamanho_indice.second << " bytes\n";
+        return saida.str();
+    }
+
+    void mostrar_estatisticas() {
+        cout << "\nESTATISTICAS ATUAIS:" << endl;
+        cout << resumo_estatisticas();
+    }
+
+    // Retorna false se o servidor não conseguiu escutar no endereço
+    bool executar_modo_servidor(const EnderecoServidor& endereco) {
+        set_modo_silencioso(true);
+
+        ServicosServidor servicos;
+        servicos.obter_faixa = [this](int id, size_t inicio, size_t tamanho, FaixaTexto& faixa) {
+            bool cache_hit;
+            return obter_faixa(id, inicio, tamanho, faixa, cache_hit);
+        };
+        servicos.estatisticas = [this]() { return resumo_estatisticas(); };
+        servicos.buscar = [this](const string& consulta, bool todas) { return resultado_busca(consulta, todas); };
+        servicos.cobertura_indice = [this]() { return to_string(indice.textos_indexados()) + "/100"; };
+
+        ServidorCache servidor(endereco, servicos);
+        if (!servidor.executar()) return false; // Bloqueia até Ctrl+C
+        mostrar_estatisticas();
+        return true;
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     cout << "SISTEMA DE LEITURA - TEXTO E VIDA" << endl;
     cout << "====================================" << endl;
+
+    // Uso: ra2_main [--dedup] [--servidor [tcp:porta | unix:/caminho.sock]]
+    bool dedup = false;
+    bool servidor = false;
+    EnderecoServidor endereco;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--dedup") {
+            dedup = true; // Blocos guardados como chunks compartilhados
+        } else if (arg == "--servidor") {
+            servidor = true;
+            if (i + 1 < argc && string(argv[i + 1]).rfind("--", 0) != 0) {
+                if (!interpretar_endereco(argv[++i], endereco)) {
+                    cout << "Endereco invalido: " << argv[i] << " (use tcp:porta ou unix:/caminho)" << endl;
+                    return 1;
+                }
+            }
+        } else {
+            cout << "Opcao desconhecida: " << arg << endl;
+            return 1;
+        }
+    }
+
+    if (servidor) {
+        GerenciadorTextos gerenciador(dedup);
+        return gerenciador.executar_modo_servidor(endereco) ? 0 : 1;
+    }
+
     cout << "Iniciando com algoritmo: FIFO (padrao)" << endl;
     cout << "Digite -1 para simulacao e troca automatica" << endl;
+    cout << "Digite -2 para buscar palavras nos textos" << endl;
     
-    GerenciadorTextos gerenciador;
+    GerenciadorTextos gerenciador(dedup);
     
     int opcao;
     do {
-        cout << "\nDigite texto (1-100), -1 simulacao, 0 sair: ";
-        cin >> opcao;
+        cout << "\nDigite texto (1-100), -1 simulacao, -2 busca, 0 sair: ";
+        if (!(cin >> opcao)) opcao = 0; // Fim da entrada encerra o programa
         
         if (opcao == 0) {
             gerenciador.mostrar_estatisticas();
@@ -184,6 +321,13 @@ int main() {
         else if (opcao == -1) {
             gerenciador.executar_modo_simulacao();
         }
+        else if (opcao == -2) {
+            cout << "Palavras (use OR entre elas para qualquer uma): ";
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            string linha;
+            getline(cin, linha);
+            gerenciador.buscar_palavras(linha);
+        }
         else if (opcao >= 1 && opcao <= 100) {
             gerenciador.abrir_texto(opcao);
         }
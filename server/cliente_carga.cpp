@@ -0,0 +1,173 @@
+// Gerador de carga para o modo servidor do ra2_main.
+// Abre várias conexões em paralelo, envia GETs em laço fechado e mede vazão e latência de cauda.
+//
+// Compilação: g++ -std=c++17 -O2 -pthread -o cliente_carga server/cliente_carga.cpp
+// Uso: cliente_carga [endereco] [conexoes] [requisicoes por conexao] [uniforme|ponderado]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iomanip>
+
+#include "servidor_cache.cpp"
+
+using namespace std;
+
+#ifdef __linux__
+
+#include <thread>
+#include <atomic>
+
+// Resultado de uma conexão do gerador
+struct ResultadoConexao {
+    vector<double> latencias_us; // Latência de cada requisição em microssegundos
+    long long bytes_recebidos = 0; // Soma dos conteúdos recebidos
+    int erros = 0; // Respostas ERR ou falhas de conexão
+};
+
+class ClienteCarga {
+private:
+    int fd; // Socket conectado ao servidor
+    string buffer; // Bytes recebidos ainda não consumidos
+
+    // Lê até o buffer ter pelo menos 'tamanho' bytes
+    bool garantir(size_t tamanho) {
+        char bloco[8192];
+        while (buffer.size() < tamanho) {
+            ssize_t lidos = read(fd, bloco, sizeof(bloco));
+            if (lidos <= 0) return false;
+            buffer.append(bloco, lidos);
+        }
+        return true;
+    }
+
+    bool ler_linha(string& linha) {
+        size_t fim;
+        while ((fim = buffer.find('\n')) == string::npos) {
+            if (!garantir(buffer.size() + 1)) return false;
+        }
+        linha = buffer.substr(0, fim);
+        buffer.erase(0, fim + 1);
+        return true;
+    }
+
+public:
+    explicit ClienteCarga(int socket_fd) : fd(socket_fd) {}
+
+    ~ClienteCarga() {
+        if (fd >= 0) close(fd);
+    }
+
+    // Envia "GET id" e lê a resposta completa; retorna o tamanho do conteúdo ou -1 em erro
+    long long get(int id) {
+        string requisicao = "GET " + to_string(id) + "\n";
+        if (write(fd, requisicao.data(), requisicao.size()) != (ssize_t)requisicao.size()) return -1;
+
+        string linha;
+        if (!ler_linha(linha) || linha.rfind("OK ", 0) != 0) return -1;
+        size_t tamanho = stoull(linha.substr(3));
+        if (!garantir(tamanho)) return -1;
+        buffer.erase(0, tamanho);
+        return (long long)tamanho;
+    }
+};
+
+// Mesmo padrão ponderado do simulador: 43% dos acessos concentrados nos textos 30-40
+int sortear_id(mt19937& gen, bool ponderado) {
+    uniform_int_distribution<> dist_aleatorio(1, 100);
+    if (!ponderado) return dist_aleatorio(gen);
+    uniform_real_distribution<> dist_prob(0.0, 1.0);
+    uniform_int_distribution<> dist_30_40(30, 40);
+    return (dist_prob(gen) < 0.43) ? dist_30_40(gen) : dist_aleatorio(gen);
+}
+
+void executar_conexao(const EnderecoServidor& endereco, int requisicoes, bool ponderado,
+                      unsigned semente, ResultadoConexao& resultado) {
+    int fd = conectar_endereco(endereco);
+    if (fd < 0) {
+        resultado.erros = requisicoes;
+        return;
+    }
+    ClienteCarga cliente(fd);
+    mt19937 gen(semente);
+    resultado.latencias_us.reserve(requisicoes);
+
+    for (int i = 0; i < requisicoes; i++) {
+        int id = sortear_id(gen, ponderado);
+        auto inicio = chrono::steady_clock::now();
+        long long tamanho = cliente.get(id);
+        auto fim = chrono::steady_clock::now();
+        if (tamanho < 0) {
+            resultado.erros += requisicoes - i; // Conexão perdida: o restante conta como erro
+            return;
+        }
+        resultado.latencias_us.push_back(chrono::duration<double, micro>(fim - inicio).count());
+        resultado.bytes_recebidos += tamanho;
+    }
+}
+
+double percentil(const vector<double>& ordenado, double p) {
+    if (ordenado.empty()) return 0;
+    size_t indice = (size_t)(p / 100.0 * (ordenado.size() - 1) + 0.5);
+    return ordenado[min(indice, ordenado.size() - 1)];
+}
+
+int main(int argc, char* argv[]) {
+    EnderecoServidor endereco;
+    if (argc >= 2 && !interpretar_endereco(argv[1], endereco)) {
+        cout << "Endereco invalido: " << argv[1] << " (use tcp:porta ou unix:/caminho)" << endl;
+        return 1;
+    }
+    int conexoes = argc >= 3 ? max(1, atoi(argv[2])) : 8;
+    int requisicoes = argc >= 4 ? max(1, atoi(argv[3])) : 200;
+    bool ponderado = argc >= 5 && string(argv[4]) == "ponderado";
+
+    cout << "GERADOR DE CARGA - " << conexoes << " conexoes x " << requisicoes
+         << " requisicoes (" << (ponderado ? "ponderado" : "uniforme") << ")" << endl;
+
+    vector<ResultadoConexao> resultados(conexoes);
+    vector<thread> threads;
+    random_device rd;
+    auto inicio = chrono::steady_clock::now();
+    for (int i = 0; i < conexoes; i++) {
+        threads.emplace_back(executar_conexao, cref(endereco), requisicoes, ponderado,
+                             rd(), ref(resultados[i]));
+    }
+    for (auto& t : threads) t.join();
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    vector<double> latencias;
+    long long bytes = 0;
+    int erros = 0;
+    for (const auto& r : resultados) {
+        latencias.insert(latencias.end(), r.latencias_us.begin(), r.latencias_us.end());
+        bytes += r.bytes_recebidos;
+        erros += r.erros;
+    }
+    sort(latencias.begin(), latencias.end());
+
+    cout << fixed << setprecision(2);
+    cout << "Requisicoes OK: " << latencias.size() << " | Erros: " << erros << endl;
+    cout << "Duracao: " << segundos << "s" << endl;
+    cout << "Vazao: " << latencias.size() / max(segundos, 1e-9) << " req/s | "
+         << bytes / max(segundos, 1e-9) / (1024 * 1024) << " MB/s" << endl;
+    cout << "Latencia (ms): p50 " << percentil(latencias, 50) / 1000
+         << " | p90 " << percentil(latencias, 90) / 1000
+         << " | p99 " << percentil(latencias, 99) / 1000
+         << " | p99.9 " << percentil(latencias, 99.9) / 1000
+         << " | max " << (latencias.empty() ? 0 : latencias.back() / 1000) << endl;
+
+    return erros == 0 ? 0 : 1;
+}
+
+#else
+
+int main() {
+    cout << "Gerador de carga disponivel apenas no Linux." << endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,484 @@
+#ifndef SERVIDOR_CACHE_CPP
+#define SERVIDOR_CACHE_CPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <sstream>
+#include <cstdint>
+#include "../core/faixa_texto.cpp"
+
+using namespace std;
+
+// Endereço de escuta/conexão: "unix:/caminho.sock" ou "tcp:porta" (somente loopback)
+struct EnderecoServidor {
+    bool unix_socket = false; // true para socket de domínio Unix
+    string caminho; // Caminho do socket Unix
+    int porta = 7070; // Porta TCP em 127.0.0.1
+};
+
+// Interpreta o texto do endereço; retorna false se o formato for inválido
+inline bool interpretar_endereco(const string& texto, EnderecoServidor& endereco) {
+    if (texto.rfind("unix:", 0) == 0 && texto.size() > 5) {
+        endereco.unix_socket = true;
+        endereco.caminho = texto.substr(5);
+        return true;
+    }
+    string porta = texto.rfind("tcp:", 0) == 0 ? texto.substr(4) : texto;
+    if (porta.empty() || porta.size() > 5 || porta.find_first_not_of("0123456789") != string::npos) return false;
+    int numero = stoi(porta); // No máximo 5 dígitos: não estoura
+    if (numero <= 0 || numero >= 65536) return false;
+    endereco.unix_socket = false;
+    endereco.porta = numero;
+    return true;
+}
+
+// Funções que o servidor usa para atender requisições sem depender do gerenciador
+struct ServicosServidor {
+    function<bool(int id, size_t inicio, size_t tamanho, FaixaTexto& faixa)> obter_faixa; // Cache ou disco; false se ID inválido
+    function<string()> estatisticas; // Texto de estatísticas para o comando STATS
+    function<string(const string& consulta, bool todas)> buscar; // IDs separados por espaço
+    function<string()> cobertura_indice; // "<indexados>/<total>" textos já no índice
+};
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <unordered_set>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+// Abre um socket conectado ao endereço (usado pelo cliente de carga); -1 em caso de erro
+inline int conectar_endereco(const EnderecoServidor& endereco) {
+    int fd;
+    if (endereco.unix_socket) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, endereco.caminho.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) { close(fd); return -1; }
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(endereco.porta);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0) { close(fd); return -1; }
+        int um = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um)); // Requisições pequenas, sem Nagle
+    }
+    return fd;
+}
+
+// Escreve todos os blocos com writev, tratando escritas parciais e socket não bloqueante
+inline bool escrever_tudo(int fd, vector<iovec>& partes) {
+    size_t atual = 0;
+    while (atual < partes.size()) {
+        int quantidade = (int)min<size_t>(partes.size() - atual, IOV_MAX);
+        ssize_t escrito = writev(fd, &partes[atual], quantidade);
+        if (escrito < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd pfd{fd, POLLOUT, 0};
+                if (poll(&pfd, 1, 5000) <= 0) return false; // Cliente parado há 5s: desiste
+                continue;
+            }
+            return false;
+        }
+        size_t restante = (size_t)escrito;
+        while (atual < partes.size() && restante >= partes[atual].iov_len) {
+            restante -= partes[atual].iov_len; // Bloco enviado por completo
+            atual++;
+        }
+        if (atual < partes.size()) {
+            partes[atual].iov_base = (char*)partes[atual].iov_base + restante; // Avança no bloco parcial
+            partes[atual].iov_len -= restante;
+        }
+    }
+    return true;
+}
+
+// Acrescenta os pedaços da faixa como iovecs, apontando direto para os buffers do cache
+inline void adicionar_faixa(vector<iovec>& partes, const FaixaTexto& faixa) {
+    for (const auto& pedaco : faixa.pedacos) {
+        partes.push_back({(void*)(pedaco.buffer->data() + pedaco.inicio), pedaco.tamanho});
+    }
+}
+
+// Servidor de textos com laço de eventos epoll compartilhado por várias threads de trabalho.
+// Protocolo em linhas de texto:
+//   GET <id>          -> "OK <n>\n" + n bytes
+//   RANGE <id> <inicio> <tamanho> -> "OK <n>\n" + n bytes da faixa pedida
+//   MGET <id> <id>... -> "VALUE <id> <n>\n" + n bytes por texto, depois "END\n"
+//   STATS             -> "OK <n>\n" + n bytes
+//   SEARCH <AND|OR> <palavra>... -> "OK <n> <indexados>/<total>\n" + IDs separados por espaço
+//                     (só o índice; com indexados < total o resultado ainda é parcial)
+//   QUIT              -> fecha a conexão
+// Erros respondem "ERR <mensagem>\n".
+class ServidorCache {
+private:
+    struct Conexao {
+        int fd; // Socket do cliente
+        string entrada; // Bytes recebidos ainda sem '\n'
+    };
+
+    static const size_t TAMANHO_MAX_LINHA = 4096; // Protege contra linhas sem fim
+    static const int MAX_IDS_MGET = 100; // Limite de textos por MGET
+
+    EnderecoServidor endereco; // Onde o servidor escuta
+    ServicosServidor servicos; // Acesso ao cache/disco
+    int num_threads; // Threads de trabalho no laço epoll
+    int fd_escuta; // Socket de escuta
+    int fd_epoll; // Instância epoll compartilhada
+    atomic<bool> rodando; // Sinaliza encerramento para as threads
+    unordered_set<Conexao*> conexoes; // Conexões abertas, fechadas no encerramento
+    mutex mutex_conexoes; // Protege 'conexoes'
+    atomic<long long> ultimo_aviso_accept{0}; // Último erro de accept mostrado (ms), limita os logs
+
+    static inline volatile sig_atomic_t sinal_parada = 0; // Marcado por SIGINT/SIGTERM
+
+    static void tratar_sinal(int) {
+        sinal_parada = 1;
+    }
+
+public:
+    ServidorCache(const EnderecoServidor& end, const ServicosServidor& serv, int threads = 0)
+        : endereco(end), servicos(serv), fd_escuta(-1), fd_epoll(-1), rodando(false) {
+        num_threads = threads > 0 ? threads : max(8, 2 * (int)thread::hardware_concurrency()); // Leitura do disco bloqueia a thread
+    }
+
+    ~ServidorCache() {
+        if (fd_epoll >= 0) close(fd_epoll);
+        if (fd_escuta >= 0) close(fd_escuta);
+        if (endereco.unix_socket) unlink(endereco.caminho.c_str());
+    }
+
+    // Bloqueia atendendo clientes até receber SIGINT/SIGTERM; retorna false se não conseguir escutar
+    bool executar() {
+        if (!abrir_escuta()) return false;
+
+        fd_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (fd_epoll < 0) {
+            cout << "Erro ao criar epoll: " << strerror(errno) << endl;
+            return false;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLONESHOT; // Um accept por vez, rearmado depois
+        ev.data.ptr = nullptr; // nullptr identifica o socket de escuta
+        epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd_escuta, &ev);
+
+        signal(SIGPIPE, SIG_IGN); // Cliente que fecha cedo não derruba o servidor
+        sinal_parada = 0;
+        signal(SIGINT, tratar_sinal);
+        signal(SIGTERM, tratar_sinal);
+
+        cout << "Servidor escutando em " << descricao_endereco()
+             << " com " << num_threads << " threads (Ctrl+C para encerrar)" << endl;
+
+        rodando = true;
+        vector<thread> threads;
+        for (int i = 0; i < num_threads; i++) {
+            threads.emplace_back(&ServidorCache::laco_eventos, this);
+        }
+        while (!sinal_parada) {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        rodando = false;
+        for (auto& t : threads) t.join();
+        for (Conexao* conexao : conexoes) { // Nenhuma thread usa mais as conexões restantes
+            close(conexao->fd);
+            delete conexao;
+        }
+        conexoes.clear();
+
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        cout << "\nServidor encerrado." << endl;
+        return true;
+    }
+
+private:
+    string descricao_endereco() const {
+        if (endereco.unix_socket) return "unix:" + endereco.caminho;
+        return "tcp:127.0.0.1:" + to_string(endereco.porta);
+    }
+
+    bool abrir_escuta() {
+        if (endereco.unix_socket) {
+            fd_escuta = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, endereco.caminho.c_str(), sizeof(addr.sun_path) - 1);
+            unlink(endereco.caminho.c_str()); // Remove socket antigo de execução anterior
+            if (fd_escuta < 0 || bind(fd_escuta, (sockaddr*)&addr, sizeof(addr)) < 0) {
+                cout << "Erro ao abrir " << descricao_endereco() << ": " << strerror(errno) << endl;
+                return false;
+            }
+        } else {
+            fd_escuta = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            int um = 1;
+            if (fd_escuta >= 0) setsockopt(fd_escuta, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(endereco.porta);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Apenas conexões locais
+            if (fd_escuta < 0 || bind(fd_escuta, (sockaddr*)&addr, sizeof(addr)) < 0) {
+                cout << "Erro ao abrir " << descricao_endereco() << ": " << strerror(errno) << endl;
+                return false;
+            }
+        }
+        if (listen(fd_escuta, SOMAXCONN) < 0) {
+            cout << "Erro no listen: " << strerror(errno) << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Cada thread espera eventos no mesmo epoll; EPOLLONESHOT garante que uma conexão
+    // é tratada por uma única thread por vez, preservando a ordem das respostas
+    void laco_eventos() {
+        epoll_event eventos[64];
+        while (rodando) {
+            int n = epoll_wait(fd_epoll, eventos, 64, 200);
+            for (int i = 0; i < n; i++) {
+                if (eventos[i].data.ptr == nullptr) {
+                    aceitar_conexoes();
+                } else {
+                    tratar_conexao((Conexao*)eventos[i].data.ptr, eventos[i].events);
+                }
+            }
+        }
+    }
+
+    void aceitar_conexoes() {
+        while (true) {
+            int fd = accept4(fd_escuta, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue; // Só esta conexão falhou
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    // EMFILE/ENFILE/ENOBUFS: a conexão continua na fila e o socket segue legível;
+                    // espera antes de rearmar para as threads não girarem sobre ele
+                    avisar_erro_accept(errno);
+                    this_thread::sleep_for(chrono::milliseconds(100));
+                }
+                break; // EAGAIN: fila vazia
+            }
+            if (!endereco.unix_socket) {
+                int um = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &um, sizeof(um));
+            }
+            Conexao* conexao = new Conexao{fd, ""};
+            {
+                lock_guard<mutex> trava(mutex_conexoes); // Antes do epoll: outra thread pode fechá-la logo
+                conexoes.insert(conexao);
+            }
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+            ev.data.ptr = conexao;
+            if (epoll_ctl(fd_epoll, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                fechar_conexao(conexao);
+            }
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLONESHOT;
+        ev.data.ptr = nullptr;
+        epoll_ctl(fd_epoll, EPOLL_CTL_MOD, fd_escuta, &ev); // Rearma o socket de escuta
+    }
+
+    // Mostra no máximo um erro de accept por segundo
+    void avisar_erro_accept(int erro) {
+        long long agora = chrono::duration_cast<chrono::milliseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+        long long anterior = ultimo_aviso_accept.load();
+        if (agora - anterior < 1000 || !ultimo_aviso_accept.compare_exchange_strong(anterior, agora)) return;
+        cout << "Erro ao aceitar conexao: " << strerror(erro) << " (tentando de novo)" << endl;
+    }
+
+    void fechar_conexao(Conexao* conexao) {
+        {
+            lock_guard<mutex> trava(mutex_conexoes);
+            conexoes.erase(conexao);
+        }
+        epoll_ctl(fd_epoll, EPOLL_CTL_DEL, conexao->fd, nullptr);
+        close(conexao->fd);
+        delete conexao;
+    }
+
+    void tratar_conexao(Conexao* conexao, uint32_t eventos) {
+        bool fechar = (eventos & (EPOLLERR | EPOLLHUP)) != 0;
+        char buffer[4096];
+
+        while (!fechar) {
+            ssize_t lidos = read(conexao->fd, buffer, sizeof(buffer));
+            if (lidos > 0) {
+                conexao->entrada.append(buffer, lidos);
+            } else if (lidos == 0) {
+                fechar = true; // Cliente encerrou; ainda responde o que já chegou
+                break;
+            } else if (errno == EINTR) {
+                continue;
+            } else {
+                if (errno != EAGAIN && errno != EWOULDBLOCK) fechar = true;
+                break;
+            }
+        }
+
+        size_t inicio = 0;
+        size_t fim;
+        while ((fim = conexao->entrada.find('\n', inicio)) != string::npos) {
+            string linha = conexao->entrada.substr(inicio, fim - inicio);
+            inicio = fim + 1;
+            if (!linha.empty() && linha.back() == '\r') linha.pop_back();
+            if (!processar_linha(conexao->fd, linha)) {
+                fechar = true;
+                break;
+            }
+        }
+        conexao->entrada.erase(0, inicio);
+        if (conexao->entrada.size() > TAMANHO_MAX_LINHA) {
+            string erro = "ERR linha muito longa\n";
+            vector<iovec> partes = {{(void*)erro.data(), erro.size()}};
+            escrever_tudo(conexao->fd, partes);
+            fechar = true;
+        }
+
+        if (fechar) {
+            fechar_conexao(conexao);
+            return;
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.ptr = conexao;
+        epoll_ctl(fd_epoll, EPOLL_CTL_MOD, conexao->fd, &ev); // Devolve a conexão ao laço
+    }
+
+    // Atende um comando; retorna false quando a conexão deve ser fechada
+    bool processar_linha(int fd, const string& linha) {
+        istringstream entrada(linha);
+        string comando;
+        entrada >> comando;
+        if (comando.empty()) return true;
+
+        if (comando == "GET") {
+            int id;
+            FaixaTexto faixa;
+            if (!(entrada >> id) || !servicos.obter_faixa(id, 0, SIZE_MAX, faixa)) {
+                return responder_erro(fd, "id invalido");
+            }
+            string cabecalho = "OK " + to_string(faixa.tamanho()) + "\n";
+            vector<iovec> partes = {{(void*)cabecalho.data(), cabecalho.size()}};
+            adicionar_faixa(partes, faixa); // Blocos vão direto dos buffers do cache, sem concatenar
+            return escrever_tudo(fd, partes);
+        }
+        if (comando == "RANGE") {
+            int id;
+            long long inicio, tamanho;
+            FaixaTexto faixa;
+            if (!(entrada >> id >> inicio >> tamanho) || inicio < 0 || tamanho < 0) {
+                return responder_erro(fd, "uso: RANGE <id> <inicio> <tamanho>");
+            }
+            if (!servicos.obter_faixa(id, (size_t)inicio, (size_t)tamanho, faixa)) {
+                return responder_erro(fd, "id invalido");
+            }
+            string cabecalho = "OK " + to_string(faixa.tamanho()) + "\n";
+            vector<iovec> partes = {{(void*)cabecalho.data(), cabecalho.size()}};
+            adicionar_faixa(partes, faixa);
+            return escrever_tudo(fd, partes);
+        }
+        if (comando == "MGET") {
+            vector<int> ids;
+            int id;
+            while (entrada >> id) ids.push_back(id);
+            if (!entrada.eof() || ids.empty() || (int)ids.size() > MAX_IDS_MGET) {
+                return responder_erro(fd, "MGET requer de 1 a " + to_string(MAX_IDS_MGET) + " ids");
+            }
+            vector<FaixaTexto> faixas(ids.size());
+            vector<string> cabecalhos(ids.size());
+            for (size_t i = 0; i < ids.size(); i++) {
+                if (!servicos.obter_faixa(ids[i], 0, SIZE_MAX, faixas[i])) {
+                    return responder_erro(fd, "id invalido: " + to_string(ids[i]));
+                }
+                cabecalhos[i] = "VALUE " + to_string(ids[i]) + " " + to_string(faixas[i].tamanho()) + "\n";
+            }
+            static const string fim_resposta = "END\n";
+            vector<iovec> partes;
+            for (size_t i = 0; i < ids.size(); i++) {
+                partes.push_back({(void*)cabecalhos[i].data(), cabecalhos[i].size()});
+                adicionar_faixa(partes, faixas[i]);
+            }
+            partes.push_back({(void*)fim_resposta.data(), fim_resposta.size()});
+            return escrever_tudo(fd, partes);
+        }
+        if (comando == "STATS") {
+            string corpo = servicos.estatisticas();
+            string cabecalho = "OK " + to_string(corpo.size()) + "\n";
+            vector<iovec> partes = {
+                {(void*)cabecalho.data(), cabecalho.size()},
+                {(void*)corpo.data(), corpo.size()}
+            };
+            return escrever_tudo(fd, partes);
+        }
+        if (comando == "SEARCH") {
+            string modo, consulta;
+            entrada >> modo;
+            getline(entrada, consulta);
+            if ((modo != "AND" && modo != "OR") || consulta.find_first_not_of(' ') == string::npos) {
+                return responder_erro(fd, "uso: SEARCH <AND|OR> <palavra>...");
+            }
+            string cobertura = servicos.cobertura_indice(); // Antes da busca: nunca superestima
+            string corpo = servicos.buscar(consulta, modo == "AND");
+            string cabecalho = "OK " + to_string(corpo.size()) + " " + cobertura + "\n";
+            vector<iovec> partes = {
+                {(void*)cabecalho.data(), cabecalho.size()},
+                {(void*)corpo.data(), corpo.size()}
+            };
+            return escrever_tudo(fd, partes);
+        }
+        if (comando == "QUIT") {
+            return false;
+        }
+        return responder_erro(fd, "comando desconhecido");
+    }
+
+    bool responder_erro(int fd, const string& mensagem) {
+        string resposta = "ERR " + mensagem + "\n";
+        vector<iovec> partes = {{(void*)resposta.data(), resposta.size()}};
+        return escrever_tudo(fd, partes);
+    }
+};
+
+#else
+
+// Sem epoll (ex.: Windows): o modo servidor apenas informa que não está disponível
+class ServidorCache {
+public:
+    ServidorCache(const EnderecoServidor&, const ServicosServidor&, int = 0) {}
+
+    bool executar() {
+        cout << "Modo servidor disponivel apenas no Linux (epoll)." << endl;
+        return false;
+    }
+};
+
+#endif
+
+#endif
@@ -67,7 +67,8 @@ def criar_dados_exemplo():
         ],
         "info_geral": {
             "total_testes": 900,
-            "tamanho_cache": 10,
+            "tamanho_cache": 64,
+            "tamanho_bloco": 1024,
             "algoritmos_testados": 3,
             "metodos_acesso": ["Uniforme", "Poisson", "Ponderado"]
         }
@@ -183,7 +184,7 @@ def criar_dashboard(dados_processados):
     ax_info_geral.text(0.5, 0.5,
         f"INFORMACOES GERAIS\n\n"
         f"Total de testes: {info_geral['total_testes']}\n"
-        f"Tamanho do cache: {info_geral['tamanho_cache']}\n"
+        f"Tamanho do cache: {info_geral['tamanho_cache']} blocos de {info_geral.get('tamanho_bloco', 1024)} B\n"
         f"Algoritmos: {info_geral['algoritmos_testados']}\n"
         f"Metodos de acesso:\n"
         f"  - {info_geral['metodos_acesso'][0]}\n"
@@ -10,10 +10,15 @@
 #include <thread>
 #include <fstream>
 #include <iomanip>
+#include <list>
+#include <unordered_map>
+#include <sstream>
 #include "../algorithms/algoritmo_cache.cpp"
 #include "../algorithms/cache_fifo.cpp"
 #include "../algorithms/cache_lru.cpp"
 #include "../algorithms/cache_2q.cpp"
+#include "../core/armazem_chunks.cpp"
+#include "../core/cache_blocos.cpp"
 
 using namespace std;
 
@@ -26,9 +31,19 @@ struct ResultadoSimulacao {
     vector<int> total_hits; // Total de hits por algoritmo
 };
 
+// Hits com e sem dedup para o mesmo orçamento de memória
+struct ResultadoDedup {
+    string cenario; // Conjunto de textos usado
+    int hits_sem_dedup; // Hits guardando os textos inteiros
+    int hits_com_dedup; // Hits guardando chunks compartilhados
+    int total_requisicoes; // Requisições simuladas
+    double razao_dedup; // Bytes do corpus / bytes ocupados com dedup por bloco (chunks, referências e controle)
+};
+
 class Simulador {
 private:
     vector<string> caminhos_textos; // Lista de caminhos para os textos simulados
+    vector<size_t> tamanhos_textos; // Tamanho real de cada texto, para dividir em blocos
 
 public:
     Simulador() {
@@ -38,15 +53,22 @@ public:
     // Gera os caminhos dos textos simulados
     void carregar_lista_textos() {
         caminhos_textos.resize(100); // Define 100 textos simulados
+        tamanhos_textos.resize(100);
         for (int i = 0; i < 100; i++) {
             caminhos_textos[i] = "texts/" + to_string(i + 1) + ".txt"; // Gera os caminhos
+            ifstream arquivo(caminhos_textos[i], ios::binary | ios::ate); // Só o tamanho
+            tamanhos_textos[i] = arquivo.is_open() ? (size_t)arquivo.tellg() : 0;
         }
     }
 
-    // Simula a leitura de um texto do disco com atraso
-    string carregar_texto_disco_simulacao(int id) {
+    // Simula a leitura de uma faixa de um texto do disco com atraso
+    string carregar_faixa_disco_simulacao(int id, size_t inicio, size_t tamanho) {
         this_thread::sleep_for(chrono::milliseconds(50)); // Simula atraso de leitura
-        return "Conteudo simulado do texto " + to_string(id) + " com muitas palavras... ";
+        string conteudo = "Conteudo simulado do texto " + to_string(id) + " com muitas palavras... ";
+        string faixa;
+        faixa.reserve(tamanho);
+        while (faixa.size() < tamanho) faixa += conteudo[(inicio + faixa.size()) % conteudo.size()];
+        return faixa;
     }
 
     // Gera uma sequência de acessos misturados com diferentes padrões
@@ -94,43 +116,46 @@ public:
         return sequencia;
     }
 
-    // Executa a simulação completa para todos os algoritmos
+    // Executa a simulação completa para todos os algoritmos. Cada acesso é a prévia de um
+    // texto, lida pelo mesmo CacheBlocos do modo interativo (64 blocos de 1 KB), para que o
+    // vencedor seja escolhido na granularidade em que será instalado
     ResultadoSimulacao executar_simulacao_completa() {
         cout << "\n🎯 INICIANDO MODO SIMULACAO AVANCADO..." << endl;
         
-        CacheFIFO algoritmo_fifo; // Algoritmo FIFO
-        CacheLRU algoritmo_lru; // Algoritmo LRU
-        Cache2Q algoritmo_2q; // Algoritmo 2Q
-        
-        vector<pair<AlgoritmoCache*, string>> algoritmos = {
-            {&algoritmo_fifo, "FIFO"},
-            {&algoritmo_lru, "LRU"},
-            {&algoritmo_2q, "2Q"}
+        vector<pair<function<AlgoritmoCache*()>, string>> algoritmos = {
+            {[]() { return new CacheFIFO(CacheBlocos::CAPACIDADE_BLOCOS); }, "FIFO"},
+            {[]() { return new CacheLRU(CacheBlocos::CAPACIDADE_BLOCOS); }, "LRU"},
+            {[]() { return new Cache2Q(CacheBlocos::CAPACIDADE_BLOCOS); }, "2Q"}
+        };
+        auto leitor = [this](int id, size_t inicio, size_t tamanho) {
+            return carregar_faixa_disco_simulacao(id, inicio, tamanho);
         };
         
         ResultadoSimulacao resultados;
         
-        for (auto& [algoritmo, nome] : algoritmos) {
+        for (auto& [criar_algoritmo, nome] : algoritmos) {
             cout << "\n🔍 Testando " << nome << "..." << endl;
-            algoritmo->set_modo_silencioso(true); // Desativa logs internos
             
             double tempo_total = 0;
             int total_requisicoes = 0;
+            int hits = 0;
+            int misses = 0;
+            Metricas metricas; // Só para o CacheBlocos; não é exportada
             
             for (int usuario = 1; usuario <= 3; usuario++) {
                 cout << "   👤 Usuario " << usuario << ": ";
                 
-                algoritmo->limpar_cache(); // Limpa o cache para cada usuário
+                CacheBlocos cache(criar_algoritmo(), leitor, &metricas); // Cache vazio para cada usuário
+                cache.set_modo_silencioso(true); // Desativa logs internos
                 
                 vector<int> sequencia = gerar_sequencia_acessos_misturados();
                 
                 for (int texto_id : sequencia) {
                     auto inicio = chrono::steady_clock::now();
-                    string conteudo = algoritmo->buscar_texto(texto_id);
-                    if (conteudo.empty()) {
-                        string conteudo_disco = carregar_texto_disco_simulacao(texto_id);
-                        algoritmo->carregar_texto(texto_id, conteudo_disco);
-                    }
+                    bool cache_hit;
+                    cache.ler_faixa(texto_id, 0, CacheBlocos::TAMANHO_BLOCO, tamanhos_textos[texto_id - 1], cache_hit);
+                    if (cache_hit) hits++;
+                    else misses++;
                     auto fim = chrono::steady_clock::now();
                     auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
                     tempo_total += duracao.count();
@@ -139,26 +164,95 @@ public:
                 cout << "✅ Concluido" << endl;
             }
             
-            auto stats = algoritmo->get_estatisticas();
             double tempo_medio = tempo_total / total_requisicoes; // Calcula tempo médio
-            double taxa_hit = (stats.first * 100.0) / max(1, stats.first + stats.second); // Calcula taxa de hits
+            double taxa_hit = (hits * 100.0) / max(1, hits + misses); // Calcula taxa de hits
             
             resultados.algoritmos.push_back(nome);
             resultados.tempo_medio.push_back(tempo_medio);
             resultados.taxa_hit.push_back(taxa_hit);
-            resultados.total_misses.push_back(stats.second);
-            resultados.total_hits.push_back(stats.first);
+            resultados.total_misses.push_back(misses);
+            resultados.total_hits.push_back(hits);
             
             cout << "   📊 " << nome << " - Tempo: " << tempo_medio << "ms";
-            cout << " | Hits: " << stats.first << " | Misses: " << stats.second;
+            cout << " | Hits: " << hits << " | Misses: " << misses;
             cout << " | Taxa: " << taxa_hit << "%" << endl;
         }
         
         return resultados;
     }
 
+    // Hits de leituras de textos inteiros (como o GET do servidor) no mesmo CacheBlocos do
+    // modo real, com LRU: sem dedup cabem 64 blocos; com dedup, o que couber em ORCAMENTO_BYTES
+    int simular_cache_blocos(const vector<int>& sequencia, const vector<string>& textos, bool dedup) {
+        Metricas metricas; // Só para o CacheBlocos; não é exportada
+        CacheBlocos cache(new CacheLRU(CacheBlocos::CAPACIDADE_BLOCOS),
+            [&textos](int id, size_t inicio, size_t tamanho) { return textos[id - 1].substr(inicio, tamanho); },
+            &metricas, dedup);
+        cache.set_modo_silencioso(true);
+        int hits = 0;
+        for (int id : sequencia) {
+            bool cache_hit;
+            cache.ler_faixa(id, 0, textos[id - 1].size(), textos[id - 1].size(), cache_hit);
+            if (cache_hit) hits++;
+        }
+        return hits;
+    }
+
+    // Compara hits com e sem dedup de chunks para o mesmo orçamento de memória
+    vector<ResultadoDedup> executar_simulacao_dedup() {
+        cout << "\n🧩 Dedup por chunks (CacheBlocos com LRU, orcamento de " << CacheBlocos::ORCAMENTO_BYTES / 1024
+             << " KB, textos inteiros)..." << endl;
+
+        vector<string> textos_reais(100);
+        for (int i = 0; i < 100; i++) {
+            ifstream arquivo(caminhos_textos[i], ios::binary); // Sem atraso: só compara memória
+            stringstream conteudo;
+            conteudo << arquivo.rdbuf();
+            textos_reais[i] = conteudo.str();
+        }
+
+        // Cenário sintético: todo texto começa com o mesmo trecho de 4 KB, como um cabeçalho de licença
+        string trecho_comum = textos_reais[0].substr(0, 4096);
+        vector<string> textos_com_trecho(100);
+        for (int i = 0; i < 100; i++) textos_com_trecho[i] = trecho_comum + textos_reais[i];
+
+        vector<vector<int>> sequencias;
+        for (int usuario = 1; usuario <= 3; usuario++) sequencias.push_back(gerar_sequencia_acessos_misturados());
+
+        vector<pair<string, const vector<string>*>> cenarios = {
+            {"Textos reais", &textos_reais},
+            {"Textos + trecho comum de 4 KB", &textos_com_trecho}
+        };
+
+        vector<ResultadoDedup> resultados;
+        for (auto& [nome, textos] : cenarios) {
+            ResultadoDedup r{nome, 0, 0, 0, 1.0};
+            for (const auto& sequencia : sequencias) {
+                r.hits_sem_dedup += simular_cache_blocos(sequencia, *textos, false);
+                r.hits_com_dedup += simular_cache_blocos(sequencia, *textos, true);
+                r.total_requisicoes += sequencia.size();
+            }
+            ArmazemChunks corpus; // Cortado bloco a bloco, como no cache com --dedup
+            for (const string& texto : *textos) {
+                for (size_t b = 0; b < texto.size(); b += CacheBlocos::TAMANHO_BLOCO) {
+                    corpus.armazenar(texto.substr(b, CacheBlocos::TAMANHO_BLOCO));
+                }
+            }
+            r.razao_dedup = corpus.razao_dedup();
+            resultados.push_back(r);
+
+            ostringstream razao; // Formata à parte para não mudar a precisão do cout
+            razao << fixed << setprecision(2) << r.razao_dedup;
+            cout << "   📊 " << nome << " - Hits sem dedup: " << r.hits_sem_dedup
+                 << " | com dedup: " << r.hits_com_dedup
+                 << " (" << showpos << r.hits_com_dedup - r.hits_sem_dedup << noshowpos << ")"
+                 << " | Razao: " << razao.str() << "x" << endl;
+        }
+        return resultados;
+    }
+
     // Salva os resultados da simulação em um arquivo JSON
-    void salvar_resultados_json(const ResultadoSimulacao& resultados) {
+    void salvar_resultados_json(const ResultadoSimulacao& resultados, const vector<ResultadoDedup>& dedup) {
         ofstream arquivo("docs/resultados.json");
         
         if (arquivo.is_open()) {
@@ -186,9 +280,27 @@ public:
             
             arquivo << "  \"info_geral\": {\n";
             arquivo << "    \"total_testes\": 900,\n";
-            arquivo << "    \"tamanho_cache\": 10,\n";
+            arquivo << "    \"tamanho_cache\": " << CacheBlocos::CAPACIDADE_BLOCOS << ",\n";
+            arquivo << "    \"tamanho_bloco\": " << CacheBlocos::TAMANHO_BLOCO << ",\n";
             arquivo << "    \"algoritmos_testados\": " << resultados.algoritmos.size() << ",\n";
             arquivo << "    \"metodos_acesso\": [\"Uniforme\", \"Poisson\", \"Ponderado\"]\n";
+            arquivo << "  },\n";
+
+            arquivo << "  \"dedup\": {\n";
+            arquivo << "    \"orcamento_bytes\": " << CacheBlocos::ORCAMENTO_BYTES << ",\n";
+            arquivo << "    \"cenarios\": [\n";
+            for (size_t i = 0; i < dedup.size(); i++) {
+                arquivo << "      {\n";
+                arquivo << "        \"cenario\": \"" << dedup[i].cenario << "\",\n";
+                arquivo << "        \"hits_sem_dedup\": " << dedup[i].hits_sem_dedup << ",\n";
+                arquivo << "        \"hits_com_dedup\": " << dedup[i].hits_com_dedup << ",\n";
+                arquivo << "        \"total_requisicoes\": " << dedup[i].total_requisicoes << ",\n";
+                arquivo << "        \"razao_dedup\": " << fixed << setprecision(2) << dedup[i].razao_dedup << "\n";
+                arquivo << "      }";
+                if (i < dedup.size() - 1) arquivo << ",";
+                arquivo << "\n";
+            }
+            arquivo << "    ]\n";
             arquivo << "  }\n";
             
             arquivo << "}";
@@ -201,7 +313,8 @@ public:
     // Executa a simulação e identifica o algoritmo vencedor
     string executar_simulacao() {
         ResultadoSimulacao resultados = executar_simulacao_completa();
-        salvar_resultados_json(resultados); 
+        vector<ResultadoDedup> resultados_dedup = executar_simulacao_dedup();
+        salvar_resultados_json(resultados, resultados_dedup); 
         
         string algoritmo_vencedor = resultados.algoritmos[0];
         double melhor_taxa = resultados.taxa_hit[0];